@@ -0,0 +1,120 @@
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cfloat>
+#include <algorithm>
+#include <inttypes.h>
+
+#include "qpsk_demap.h"
+
+/*
+g++ -o bench_demap -std=c++17 -O3 -I../gr-droneid/lib bench_demap.cpp ../gr-droneid/lib/qpsk_demap.cc
+
+Throughput of the equalize and slice step of the burst decoder, one call
+per data symbol of 600 subcarriers. burst_decoder::demap() makes two calls
+of 300, one per run of FFT bins.
+*/
+
+using namespace gr::droneid;
+using cxf_t = std::complex<float>;
+
+constexpr int CARRIERS = 600;
+
+// The per-subcarrier loop of decoder::decode_QPSK(), division and branches
+void
+demap_scalar(const cxf_t* y, const cxf_t* h, const uint8_t* gs, int8_t* llr, int num)
+{
+  for (int k = 0; k < num; ++k) {
+    const cxf_t v = y[k] / h[k];
+    uint8_t b0, b1;
+    if (v.real() > 0 && v.imag() > 0) {
+      b0 = 0; b1 = 0;
+    } else if (v.real() > 0 && v.imag() < 0) {
+      b0 = 0; b1 = 1;
+    } else if (v.real() < 0 && v.imag() > 0) {
+      b0 = 1; b1 = 0;
+    } else {
+      b0 = 1; b1 = 1;
+    }
+    llr[2 * k] = (b0 ^ gs[2 * k]) ? 63 : -63;
+    llr[2 * k + 1] = (b1 ^ gs[2 * k + 1]) ? 63 : -63;
+  }
+}
+
+template <typename F>
+double
+msps(F f, int rounds)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    f();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  const double s = std::chrono::duration<double>(end - start).count();
+  return (double) rounds * CARRIERS / s / 1.e6;
+}
+
+int
+main(int argc, char** argv)
+{
+  const int rounds = argc > 1 ? std::stoi(argv[1]) : 200000;
+
+  std::mt19937 gen(1);
+  std::normal_distribution<float> d(0.f, 1.f);
+  std::vector<cxf_t> y(CARRIERS), h(CARRIERS), w(CARRIERS);
+  std::vector<uint8_t> gs(2 * CARRIERS);
+  std::vector<float> sign(2 * CARRIERS);
+  for (int k = 0; k < CARRIERS; ++k) {
+    y[k] = cxf_t(d(gen), d(gen));
+    h[k] = cxf_t(d(gen), d(gen));
+    w[k] = 1.f / h[k];
+  }
+  for (int k = 0; k < 2 * CARRIERS; ++k) {
+    gs[k] = gen() & 1;
+    sign[k] = gs[k] ? 1.f : -1.f;
+  }
+  std::vector<int8_t> ref(2 * CARRIERS), llr(2 * CARRIERS);
+
+  std::cout << "Subcarriers per call: " << CARRIERS << ", calls: " << rounds << "\n";
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << std::setw(10) << "scalar" << " hard: " << std::setw(9)
+            << msps([&] { demap_scalar(y.data(), h.data(), gs.data(), ref.data(), CARRIERS); }, rounds)
+            << " Msc/s\n";
+  for (const auto &a: qpsk_demap_archs()) {
+    std::cout << std::setw(10) << a.name << " hard: " << std::setw(9)
+              << msps([&] { a.demap(y.data(), w.data(), sign.data(), FLT_MAX, llr.data(), CARRIERS); }, rounds)
+              << " Msc/s   soft: " << std::setw(9)
+              << msps([&] { a.demap(y.data(), w.data(), sign.data(), 20.f, llr.data(), CARRIERS); }, rounds)
+              << " Msc/s\n";
+  }
+
+  // Sanity check, hard decisions as decode_QPSK() and soft values equal
+  // across the implementations
+  int errors = 0;
+  std::vector<int8_t> soft(2 * CARRIERS);
+  qpsk_demap_archs().front().demap(y.data(), w.data(), sign.data(), 20.f, soft.data(), CARRIERS);
+  for (const auto &a: qpsk_demap_archs()) {
+    a.demap(y.data(), w.data(), sign.data(), FLT_MAX, llr.data(), CARRIERS);
+    if (llr != ref) {
+      std::cout << a.name << " hard decisions differ\n";
+      errors++;
+    }
+    a.demap(y.data(), w.data(), sign.data(), 20.f, llr.data(), CARRIERS);
+    if (llr != soft) {
+      std::cout << a.name << " soft values differ\n";
+      errors++;
+    }
+    // One run of bins like in the decoder, not a multiple of 8
+    std::fill(llr.begin(), llr.end(), 0);
+    a.demap(y.data() + 1, w.data() + 1, sign.data() + 2, 20.f, llr.data() + 2, CARRIERS / 2);
+    if (!std::equal(llr.begin() + 2, llr.begin() + 2 + CARRIERS, soft.begin() + 2) || llr[0] || llr[CARRIERS + 2]) {
+      std::cout << a.name << " run of " << CARRIERS / 2 << " differs\n";
+      errors++;
+    }
+  }
+  std::cout << "errors: " << errors << "\n";
+  return errors != 0;
+}
@@ -0,0 +1,122 @@
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <string>
+#include <inttypes.h>
+
+#include "threshold_scan.h"
+
+/*
+g++ -o bench_trigger -std=c++17 -O3 -I../gr-droneid/lib bench_trigger.cpp ../gr-droneid/lib/threshold_scan.cc
+
+Throughput of the trigger threshold scan on noise-only correlator output,
+i.e. the steady state of single_trigger/dual_trigger when no burst is present.
+*/
+
+using namespace gr::droneid;
+
+// The per-sample loop the trigger blocks used before the scan kernels
+int
+find_first_above_scalar(const float* t1, int num, float thr)
+{
+  for (int idx = 0; idx < num; ++idx) {
+    if (*t1 > thr) {
+      return idx;
+    }
+    t1++;
+  }
+  return num;
+}
+
+int
+find_first_above_both_scalar(const float* t1, const float* t2, int num, float thr)
+{
+  for (int idx = 0; idx < num; ++idx) {
+    const bool trigger1 = (*t1 > thr);
+    const bool trigger2 = (*t2 > thr);
+    if (trigger1 && trigger2) {
+      return idx;
+    }
+    t1++;
+    t2++;
+  }
+  return num;
+}
+
+std::vector<float>
+noise_mag2(size_t num, uint32_t seed)
+{
+  // |n|^2 of unit power complex gaussian noise, like complex_to_mag_squared
+  std::mt19937 gen(seed);
+  std::normal_distribution<float> d(0.f, (float) M_SQRT1_2);
+  std::vector<float> v(num);
+  for (auto &x: v) {
+    const float i = d(gen);
+    const float q = d(gen);
+    x = i * i + q * q;
+  }
+  return v;
+}
+
+template <typename F>
+double
+msps(F f, int rounds, size_t num)
+{
+  int sink = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    sink += f();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  if (sink != rounds * (int) num) {
+    std::cout << "unexpected trigger in noise\n";
+  }
+  const double s = std::chrono::duration<double>(end - start).count();
+  return (double) rounds * num / s / 1.e6;
+}
+
+int
+main(int argc, char** argv)
+{
+  // One scheduler buffer worth of samples, fits in L1/L2 like the real thing
+  constexpr int N = 8192;
+  constexpr float thr = 50.f; // P(|n|^2 > 50) ~ 2e-22
+  const int rounds = argc > 1 ? std::stoi(argv[1]) : 20000;
+
+  std::vector<float> t1 = noise_mag2(N, 1);
+  std::vector<float> t2 = noise_mag2(N, 2);
+
+  std::cout << "Samples per call: " << N << ", calls: " << rounds << "\n";
+  std::cout << std::fixed << std::setprecision(1);
+
+  std::cout << std::setw(10) << "scalar" << " single: " << std::setw(9)
+            << msps([&] { return find_first_above_scalar(t1.data(), N, thr); }, rounds, N)
+            << " Msps   dual: " << std::setw(9)
+            << msps([&] { return find_first_above_both_scalar(t1.data(), t2.data(), N, thr); }, rounds, N)
+            << " Msps\n";
+
+  for (const auto &a: threshold_scan_archs()) {
+    std::cout << std::setw(10) << a.name << " single: " << std::setw(9)
+              << msps([&] { return a.above(t1.data(), N, thr); }, rounds, N)
+              << " Msps   dual: " << std::setw(9)
+              << msps([&] { return a.above_both(t1.data(), t2.data(), N, thr, thr); }, rounds, N)
+              << " Msps\n";
+  }
+
+  // Sanity check, every implementation must agree on where the hit is
+  int errors = 0;
+  for (int pos: {0, 7, 8, 31, 32, 33, 100, N - 1}) {
+    std::vector<float> a = t1, b = t2;
+    a[pos] = b[pos] = 2.f * thr;
+    for (const auto &arch: threshold_scan_archs()) {
+      if (arch.above(a.data(), N, thr) != pos || arch.above_both(a.data(), b.data(), N, thr, thr) != pos) {
+        std::cout << arch.name << " failed at " << pos << "\n";
+        errors++;
+      }
+    }
+  }
+  std::cout << "errors: " << errors << "\n";
+  return errors != 0;
+}
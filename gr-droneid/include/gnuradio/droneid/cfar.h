@@ -0,0 +1,29 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_CFAR_H
+#define INCLUDED_DRONEID_CFAR_H
+
+namespace gr {
+namespace droneid {
+
+/*!
+ * \brief Trigger threshold modes
+ * \ingroup droneid
+ *
+ * CFAR_OFF uses the threshold as an absolute correlator level. The CFAR
+ * modes estimate the correlator noise floor from the preceding cells and
+ * trigger at a level in dB above it, either from the mean of the cells
+ * (cell-averaging) or from their upper quartile (ordered-statistic), which
+ * is not pulled up by bursts in the reference cells.
+ */
+enum cfar_mode_t { CFAR_OFF = 0, CFAR_CA = 1, CFAR_OS = 2 };
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_CFAR_H */
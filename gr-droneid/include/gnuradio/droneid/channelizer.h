@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_CHANNELIZER_H
+#define INCLUDED_DRONEID_CHANNELIZER_H
+
+#include <gnuradio/droneid/api.h>
+#include <gnuradio/sync_decimator.h>
+
+namespace gr {
+namespace droneid {
+
+/*!
+ * \brief Polyphase filterbank channelizer for the DroneID channels
+ * \ingroup droneid
+ *
+ * Splits a wideband stream into one decimated output per channel with a
+ * single polyphase filterbank and one FFT per output sample, instead of a
+ * rotator and a full rate FIR per channel. The channels don't have to sit
+ * on the filterbank bins, e.g. 2414.5/2429.5/2444.5/2459.5 MHz around
+ * 2437 MHz at 61.44 Msps. Each channel is taken from the nearest bin and
+ * the residual offset is removed at the output rate.
+ *
+ * Every output carries an "fc" tag with the channel center frequency on
+ * its first sample and after each retune, which the trigger blocks pick up
+ * instead of their fc parameter.
+ */
+class DRONEID_API channelizer : virtual public gr::sync_decimator
+{
+public:
+    typedef std::shared_ptr<channelizer> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of droneid::channelizer.
+     *
+     * To avoid accidental use of raw pointers, droneid::channelizer's
+     * constructor is in a private implementation
+     * class. droneid::channelizer::make is the public interface for
+     * creating new instances.
+     *
+     * \param samp_rate Input sample rate in Hz
+     * \param center_freq Input center frequency in MHz
+     * \param channel_freqs Channel center frequencies in MHz, one output each
+     * \param decimation Input samples per output sample
+     * \param num_bins Filterbank size, a multiple of decimation. Twice the
+     *        decimation keeps channels between bins inside the passband
+     * \param taps Prototype low pass at the input rate, designed for the
+     *        10 MHz DroneID channel if empty
+     */
+    static sptr make(double samp_rate,
+                     float center_freq,
+                     const std::vector<float>& channel_freqs,
+                     int decimation = 4,
+                     int num_bins = 8,
+                     const std::vector<float>& taps = std::vector<float>());
+    virtual void set_center_freq(float /*center_freq*/) = 0;
+    virtual float center_freq() const = 0;
+    virtual std::vector<float> channel_freqs() const = 0;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_CHANNELIZER_H */
@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_DECODER_H
+#define INCLUDED_DRONEID_DECODER_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/droneid/api.h>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*!
+ * \brief Decode DJI DroneID bursts from trigger PDUs
+ * \ingroup droneid
+ *
+ * Takes the capture PDUs of the trigger blocks on "pdu", the first ZC
+ * symbol expected pre_trigger samples in. Removes the CFO, finds the burst,
+ * equalizes from the ZC symbols, descrambles and turbo decodes. The 176
+ * byte frame goes out on "pdu" as a u8vector, the trigger metadata is kept
+ * and "crc_ok", "crc", "cfo" (Hz), "frame_snr" (dB, from the ZC symbols),
+ * "burst_start", "sto" (the fraction of a sample the burst starts after
+ * burst_start) and "sco" (ppm) are added.
+ *
+ * The trigger's pre_trigger has to cover the burst before the first ZC
+ * symbol and the noise window before that, at least zc4_offset() plus a
+ * quarter symbol, 2520 samples at 15.36 Msps. A pre_trigger below half a
+ * symbol, e.g. the default 0, is read as a capture that starts with the
+ * burst.
+ *
+ * At 15.36, 30.72 or 61.44 Msps the capture is demodulated at its rate
+ * with a 1024, 2048 or 4096 point FFT. Other rates, e.g. 50 Msps, are
+ * resampled to 15.36 Msps first with the resampler block's filter.
+ *
+ * Frames failing the CRC are dropped when crc_only is set.
+ *
+ * Decoding runs on a pool of threads threads, each with its own decoder.
+ * The PDUs are queued for them, queue_depth per thread, and the frames go
+ * out in the order the PDUs came in. A PDU that finds its queue full is
+ * dropped and counted in frames_dropped().
+ */
+class DRONEID_API decoder : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<decoder> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of droneid::decoder.
+     *
+     * To avoid accidental use of raw pointers, droneid::decoder's
+     * constructor is in a private implementation
+     * class. droneid::decoder::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(double samp_rate = 15.36e6,
+                     bool crc_only = false,
+                     int threads = 1,
+                     int queue_depth = 16);
+
+    //! Frames that passed the CRC
+    virtual uint64_t frames_ok() const = 0;
+    //! Frames that failed the CRC or weren't in the capture
+    virtual uint64_t frames_failed() const = 0;
+    //! PDUs dropped on a full queue
+    virtual uint64_t frames_dropped() const = 0;
+    //! PDUs waiting for a decode thread
+    virtual size_t queue_depth() const = 0;
+    //! Fraction of the time each decode thread has been busy since start
+    virtual std::vector<float> utilisation() const = 0;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_DECODER_H */
@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_FFT_PLANS_H
+#define INCLUDED_DRONEID_FFT_PLANS_H
+
+#include <gnuradio/droneid/api.h>
+#include <gnuradio/gr_complex.h>
+#include <memory>
+#include <string>
+
+typedef struct fftwf_plan_s* fftwf_plan;
+
+namespace gr {
+namespace droneid {
+
+/*
+ * A batched complex FFTW plan, howmany transforms of n points, idist and
+ * odist apart, out of place. Shared and executed concurrently by any
+ * number of users, on their own buffers. in and out must be SIMD aligned,
+ * e.g. volk::vector, and must not overlap.
+ */
+class DRONEID_API fft_plan
+{
+private:
+    fftwf_plan m_plan;
+
+public:
+    explicit fft_plan(fftwf_plan p);
+    ~fft_plan();
+    fft_plan(const fft_plan&) = delete;
+    fft_plan& operator=(const fft_plan&) = delete;
+
+    void execute(const gr_complex* in, gr_complex* out) const;
+};
+
+/*
+ * Process wide registry of the library's FFTW plans.
+ *
+ * Planning and wisdom go through gr::fft::planner::mutex(), the lock the
+ * gr-fft blocks use, so decoders can be built from any thread. Equal plans
+ * are planned once and shared while someone holds them.
+ *
+ * The wisdom file is imported before the first plan and exported after
+ * each plan that was measured, so only the first start of a unit pays for
+ * FFTW_MEASURE or FFTW_PATIENT. The defaults come from the [droneid]
+ * section of the GNU Radio config:
+ *
+ *   [droneid]
+ *   fftw_wisdom = /path/to/wisdom   ; default ~/.gnuradio/droneid_fftw_wisdom
+ *   fftw_effort = measure           ; estimate, measure, patient or wisdom_only
+ *
+ * With wisdom_only a plan that isn't in the wisdom file throws instead of
+ * being measured, startup either is fast or fails.
+ *
+ * The burst decoder takes all its plans from here, the batched one of the
+ * 8 symbols and the single ZC symbol and timing correlation ones, so a
+ * pool of decoders plans each size once.
+ */
+class DRONEID_API fft_plans
+{
+public:
+    enum effort_t { ESTIMATE, MEASURE, PATIENT, WISDOM_ONLY };
+
+    // Override the config, for plans made after the call. An empty path
+    // turns the wisdom file off.
+    static void set_wisdom_file(const std::string& path);
+    static std::string wisdom_file();
+    static void set_effort(effort_t effort);
+    static effort_t effort();
+    // Throws std::invalid_argument for an unknown name
+    static effort_t effort_from_string(const std::string& name);
+
+    // Export the wisdom of all plans so far, false if that failed
+    static bool save_wisdom();
+
+    static std::shared_ptr<const fft_plan>
+    get(int n, int howmany, int idist, int odist, bool forward);
+    // Plans currently held by someone
+    static size_t size();
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_FFT_PLANS_H */
@@ -0,0 +1,100 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_MULTI_TRIGGER_H
+#define INCLUDED_DRONEID_MULTI_TRIGGER_H
+
+#include <gnuradio/droneid/api.h>
+#include <gnuradio/droneid/cfar.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+namespace droneid {
+
+/*!
+ * \brief k-of-n trigger on up to four correlator streams
+ * \ingroup droneid
+ *
+ * Triggers where at least k of the num_inputs correlator streams are above
+ * their threshold, k == num_inputs is an AND and k == 1 an OR. Every
+ * stream has its own CFAR noise floor, the TOA comes from the first one.
+ * Input 0 is IQ, inputs 1..num_inputs the correlator streams.
+ *
+ * Each burst goes out as a PDU on the pdu port. With the optional stream
+ * output connected it goes out there instead: pre_trigger + chunk_size
+ * samples with a "packet_len" tag and the PDU metadata as tags on the first
+ * sample. A full output buffer then holds the input back.
+ */
+class DRONEID_API multi_trigger : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<multi_trigger> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of droneid::multi_trigger.
+     *
+     * To avoid accidental use of raw pointers, droneid::multi_trigger's
+     * constructor is in a private implementation
+     * class. droneid::multi_trigger::make is the public interface for
+     * creating new instances.
+     *
+     * \param num_inputs Number of correlator streams, 1 to 4
+     * \param k Number of streams that have to be above threshold, 1 to num_inputs
+     * \param fc Channel center frequency, passed on in the PDU metadata.
+     *        An "fc" tag on the input, e.g. from the channelizer, replaces it
+     * \param threshold Correlator trigger level
+     * \param chunk_size Number of samples captured from the trigger sample on
+     * \param pre_trigger Number of samples before the trigger sample that are
+     *        also put in the PDU, which then holds pre_trigger + chunk_size samples
+     * \param cfar_mode CFAR_OFF triggers on threshold, the CFAR modes on
+     *        cfar_threshold_db above the running correlator noise floor
+     * \param cfar_threshold_db Trigger level above the noise floor in dB
+     * \param samp_rate Input sample rate, for the "rx_time" metadata. Where
+     *        the correlator fires in the burst isn't known here, so the
+     *        metadata has only "clipped", over the whole capture, and not
+     *        the power and SNR of zc_detector
+     * \param holdoff Samples after a trigger in which further threshold
+     *        crossings are counted as suppressed instead of starting a
+     *        capture, a burst length (8776 at 15.36 Msps) gives one PDU per burst
+     * \param peak_window Correlator samples from the trigger on that are
+     *        searched for the peak the TOA is taken from
+     */
+    static sptr make(int num_inputs,
+                     int k,
+                     float fc,
+                     float threshold,
+                     int chunk_size,
+                     int pre_trigger = 0,
+                     cfar_mode_t cfar_mode = CFAR_OFF,
+                     float cfar_threshold_db = 12.f,
+                     double samp_rate = 15.36e6,
+                     int holdoff = 0,
+                     int peak_window = 16);
+    virtual void set_threshold(float /*threshold*/) = 0;
+    virtual void set_fc(float /*fc*/) = 0;
+    //! Number of captures currently being collected
+    virtual int active_captures() const = 0;
+    virtual void set_cfar_mode(cfar_mode_t /*mode*/) = 0;
+    virtual void set_cfar_threshold_db(float /*db*/) = 0;
+    //! Current noise floor estimate of the first correlator stream, linear
+    virtual float noise_floor() const = 0;
+    //! Threshold crossings suppressed by the holdoff so far
+    virtual uint64_t suppressed_triggers() const = 0;
+    virtual void set_holdoff(int /*holdoff*/) = 0;
+    /*!
+     * \brief Absolute time of item 0, used until an rx_time tag comes in.
+     *
+     * With rx_time tags, or an epoch, the PDU metadata has "rx_time", the
+     * TOA as a (uint64 seconds, double fraction) tuple like the tag.
+     */
+    virtual void set_epoch(uint64_t /*secs*/, double /*frac*/) = 0;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_MULTI_TRIGGER_H */
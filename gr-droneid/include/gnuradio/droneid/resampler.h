@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_RESAMPLER_H
+#define INCLUDED_DRONEID_RESAMPLER_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/droneid/api.h>
+
+namespace gr {
+namespace droneid {
+
+/*!
+ * \brief Rational polyphase resampler with a frequency shift
+ * \ingroup droneid
+ *
+ * Resamples by interpolation / decimation, e.g. 384 / 1250 from 50 Msps
+ * to 15.36 Msps, and moves shift_freq to DC on the way. Only the filter
+ * branch of each output is computed and the shift is folded into the
+ * taps, there is no pass over the input rate samples.
+ *
+ * The decoder uses the same resampler on each capture when its sample
+ * rate isn't one it demodulates directly.
+ *
+ * rx_rate tags are scaled to the output rate and fc tags (MHz) moved by
+ * the shift.
+ */
+class DRONEID_API resampler : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<resampler> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of droneid::resampler.
+     *
+     * To avoid accidental use of raw pointers, droneid::resampler's
+     * constructor is in a private implementation
+     * class. droneid::resampler::make is the public interface for
+     * creating new instances.
+     *
+     * \param samp_rate Input sample rate in Hz
+     * \param interpolation Interpolation, reduced with decimation
+     * \param decimation Decimation
+     * \param shift_freq Frequency in Hz, relative to the input center, that
+     *        ends up at DC
+     * \param taps Prototype low pass at interpolation times samp_rate with
+     *        a gain of interpolation, designed for the DroneID channel if
+     *        empty
+     */
+    static sptr make(double samp_rate,
+                     int interpolation = 384,
+                     int decimation = 1250,
+                     double shift_freq = 0.0,
+                     const std::vector<float>& taps = std::vector<float>());
+    virtual double out_rate() const = 0;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_RESAMPLER_H */
@@ -9,7 +9,8 @@
 #define INCLUDED_DRONEID_SINGLE_TRIGGER_H
 
 #include <gnuradio/droneid/api.h>
-#include <gnuradio/sync_block.h>
+#include <gnuradio/droneid/cfar.h>
+#include <gnuradio/block.h>
 
 namespace gr {
 namespace droneid {
@@ -18,8 +19,12 @@ namespace droneid {
  * \brief Symbol 4 single trigger 
  * \ingroup droneid
  *
+ * Each burst goes out as a PDU on the pdu port. With the optional stream
+ * output connected it goes out there instead: pre_trigger + chunk_size
+ * samples with a "packet_len" tag and the PDU metadata as tags on the first
+ * sample. A full output buffer then holds the input back.
  */
-class DRONEID_API single_trigger : virtual public gr::sync_block
+class DRONEID_API single_trigger : virtual public gr::block
 {
 public:
     typedef std::shared_ptr<single_trigger> sptr;
@@ -31,10 +36,53 @@ public:
      * constructor is in a private implementation
      * class. droneid::single_trigger::make is the public interface for
      * creating new instances.
+     *
+     * \param fc Channel center frequency, passed on in the PDU metadata.
+     *        An "fc" tag on the input, e.g. from the channelizer, replaces it
+     * \param threshold Correlator trigger level
+     * \param chunk_size Number of samples captured from the trigger sample on
+     * \param pre_trigger Number of samples before the trigger sample that are
+     *        also put in the PDU, which then holds pre_trigger + chunk_size samples
+     * \param cfar_mode CFAR_OFF triggers on threshold, the CFAR modes on
+     *        cfar_threshold_db above the running correlator noise floor
+     * \param cfar_threshold_db Trigger level above the noise floor in dB
+     * \param samp_rate Input sample rate, for the "rx_time" metadata. Where
+     *        the correlator fires in the burst isn't known here, so the
+     *        metadata has only "clipped", over the whole capture, and not
+     *        the power and SNR of zc_detector
+     * \param holdoff Samples after a trigger in which further threshold
+     *        crossings are counted as suppressed instead of starting a
+     *        capture, a burst length (8776 at 15.36 Msps) gives one PDU per burst
+     * \param peak_window Correlator samples from the trigger on that are
+     *        searched for the peak the TOA is taken from
      */
-    static sptr make(float fc, float threshold, int chunk_size);
+    static sptr make(float fc,
+                     float threshold,
+                     int chunk_size,
+                     int pre_trigger = 0,
+                     cfar_mode_t cfar_mode = CFAR_OFF,
+                     float cfar_threshold_db = 12.f,
+                     double samp_rate = 15.36e6,
+                     int holdoff = 0,
+                     int peak_window = 16);
     virtual void set_threshold(float /*threshold*/) = 0;
     virtual void set_fc(float /*fc*/) = 0;
+    //! Number of captures currently being collected
+    virtual int active_captures() const = 0;
+    virtual void set_cfar_mode(cfar_mode_t /*mode*/) = 0;
+    virtual void set_cfar_threshold_db(float /*db*/) = 0;
+    //! Current correlator noise floor estimate, linear
+    virtual float noise_floor() const = 0;
+    //! Threshold crossings suppressed by the holdoff so far
+    virtual uint64_t suppressed_triggers() const = 0;
+    virtual void set_holdoff(int /*holdoff*/) = 0;
+    /*!
+     * \brief Absolute time of item 0, used until an rx_time tag comes in.
+     *
+     * With rx_time tags, or an epoch, the PDU metadata has "rx_time", the
+     * TOA as a (uint64 seconds, double fraction) tuple like the tag.
+     */
+    virtual void set_epoch(uint64_t /*secs*/, double /*frac*/) = 0;
 };
 
 } // namespace droneid
@@ -1 +1,85 @@
-uint32_t fft_size(double samp_rate) { return std::round(samp_rate / 15.0e3); }
\ No newline at end of file
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_UTILITIES_H
+#define INCLUDED_DRONEID_UTILITIES_H
+
+#include <cmath>
+#include <cstdint>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * DroneID frame geometry, same as python/droneid/utilities.py.
+ *
+ * A burst is 8 OFDM symbols, short CP on the first seven and a long CP on
+ * the last. The ZC sequences are in symbols 2 and 4 (counting from 0), i.e.
+ * two symbols apart, the data in 0, 1, 3, 5, 6 and 7. The 4 and 6 in
+ * ZC_ROOT_SYMBOL_4/6 and zc4 are the names the ZC symbols go by elsewhere,
+ * not indices. All lengths are in samples at samp_rate, 1024 point symbols
+ * at 15.36 Msps.
+ */
+constexpr double CARRIER_SPACING = 15.0e3;
+constexpr int DATA_CARRIERS = 600;
+constexpr int NUM_SYMBOLS = 8;
+constexpr int ZC_ROOT_SYMBOL_4 = 600;
+constexpr int ZC_ROOT_SYMBOL_6 = 147;
+
+inline uint32_t fft_size(double samp_rate) { return std::round(samp_rate / CARRIER_SPACING); }
+inline uint32_t short_cp(double samp_rate) { return std::round(samp_rate * 0.0000046875); }
+inline uint32_t long_cp(double samp_rate) { return std::round(samp_rate / 192000.0); }
+
+// Burst start to the FFT window of the first ZC symbol (2), 2264 at 15.36 Msps
+inline uint32_t zc4_offset(double samp_rate)
+{
+    return 2 * (short_cp(samp_rate) + fft_size(samp_rate)) + short_cp(samp_rate);
+}
+
+// First ZC symbol to the second, 2192 at 15.36 Msps
+inline uint32_t zc_distance(double samp_rate)
+{
+    return 2 * (short_cp(samp_rate) + fft_size(samp_rate));
+}
+
+// Whole burst, 8776 at 15.36 Msps
+inline uint32_t burst_length(double samp_rate)
+{
+    return (NUM_SYMBOLS - 1) * short_cp(samp_rate) + long_cp(samp_rate) +
+           NUM_SYMBOLS * fft_size(samp_rate);
+}
+
+/*
+ * The same geometry at compile time for an N point FFT, i.e. N / 1024
+ * times 15.36 Msps. The functions above in integers, the CPs are 72 and
+ * 80 samples per 1024.
+ */
+template <int N>
+struct ofdm_geometry {
+    static_assert(N >= 1024 && N % 1024 == 0, "FFT size must be a multiple of 1024");
+    static constexpr int OVERSAMPLING = N / 1024;
+    static constexpr double SAMP_RATE = N * CARRIER_SPACING;
+    static constexpr int SHORT_CP = 72 * OVERSAMPLING;
+    static constexpr int LONG_CP = 80 * OVERSAMPLING;
+    static constexpr int SYMBOL = N + SHORT_CP;
+    static constexpr int ZC4_OFFSET = 2 * SYMBOL + SHORT_CP;
+    static constexpr int ZC_DISTANCE = 2 * SYMBOL;
+    static constexpr int BURST_LENGTH = NUM_SYMBOLS * SYMBOL + LONG_CP - SHORT_CP;
+    // First FFT bin of the data subcarriers below and above DC
+    static constexpr int LOW_BIN = N - DATA_CARRIERS / 2;
+    static constexpr int HIGH_BIN = 1;
+};
+
+static_assert(ofdm_geometry<1024>::ZC4_OFFSET == 2264 &&
+                  ofdm_geometry<1024>::ZC_DISTANCE == 2192 &&
+                  ofdm_geometry<1024>::BURST_LENGTH == 8776,
+              "15.36 Msps geometry");
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_UTILITIES_H */
@@ -0,0 +1,114 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_ZC_DETECTOR_H
+#define INCLUDED_DRONEID_ZC_DETECTOR_H
+
+#include <gnuradio/droneid/api.h>
+#include <gnuradio/droneid/cfar.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+namespace droneid {
+
+/*!
+ * \brief Symbol 4 and 6 ZC matched filter and trigger in one block
+ * \ingroup droneid
+ *
+ * Replaces the fft_filter, complex_to_mag_squared, delay and dual_trigger
+ * chain. The input is correlated against both ZC symbols with overlap-save
+ * sharing one forward FFT, the symbol 4 correlation is delayed two symbols to
+ * line up with symbol 6, and a capture starts where both are above threshold.
+ * The PDU and its metadata are the same as from dual_trigger, with the
+ * trigger sample at the start of the symbol 4 FFT window. As that places
+ * the burst, the metadata also has its "power" (mean |x|^2), "papr" (dB),
+ * and with pre_trigger reaching a quarter symbol before the burst the
+ * "noise" there and the "snr". The snr is the power ratio in dB,
+ * 10 log10((power - noise) / noise); it used to be 20 log10 of the same
+ * ratio, twice the value.
+ *
+ * With a coarse_threshold above 0 a cheap first stage runs ahead of the
+ * correlator: the CP autocorrelation on every 4th sample. The ZC correlation
+ * only runs on the overlap-save blocks that can hold a burst around a CP
+ * hit, the rest are skipped. The CP metric is the normalized coherence,
+ * SNR / (SNR + 1) on a burst and around 0.25 on noise, so around 0.7 keeps
+ * the false alarms rare.
+ *
+ * Like the trigger blocks, each burst goes out as a PDU on the pdu port or,
+ * with the optional stream output connected, there instead:
+ * pre_trigger + chunk_size samples with a "packet_len" tag and the PDU
+ * metadata as tags on the first sample. A full output buffer then holds
+ * the input back.
+ */
+class DRONEID_API zc_detector : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<zc_detector> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of droneid::zc_detector.
+     *
+     * To avoid accidental use of raw pointers, droneid::zc_detector's
+     * constructor is in a private implementation
+     * class. droneid::zc_detector::make is the public interface for
+     * creating new instances.
+     *
+     * \param fc Channel center frequency, passed on in the PDU metadata.
+     *        An "fc" tag on the input, e.g. from the channelizer, replaces it
+     * \param threshold Trigger level for the squared correlator magnitude
+     * \param chunk_size Number of samples captured from the trigger sample on
+     * \param pre_trigger Number of samples before the trigger sample that are
+     *        also put in the PDU, which then holds pre_trigger + chunk_size samples
+     * \param samp_rate Input sample rate, sets the OFDM FFT size
+     * \param cfar_mode CFAR_OFF triggers on threshold, the CFAR modes on
+     *        cfar_threshold_db above the running correlator noise floor
+     * \param cfar_threshold_db Trigger level above the noise floor in dB
+     * \param coarse_threshold CP autocorrelation level, 0 to 1, that arms
+     *        the correlator. 0 runs the correlator on every block
+     * \param holdoff Samples after a trigger in which further threshold
+     *        crossings are counted as suppressed instead of starting a
+     *        capture, a burst length (8776 at 15.36 Msps) gives one PDU per burst
+     * \param peak_window Correlator samples from the trigger on that are
+     *        searched for the peak the TOA is taken from
+     */
+    static sptr make(float fc,
+                     float threshold,
+                     int chunk_size,
+                     int pre_trigger = 0,
+                     double samp_rate = 15.36e6,
+                     cfar_mode_t cfar_mode = CFAR_OFF,
+                     float cfar_threshold_db = 12.f,
+                     float coarse_threshold = 0.f,
+                     int holdoff = 0,
+                     int peak_window = 16);
+    virtual void set_threshold(float /*threshold*/) = 0;
+    virtual void set_fc(float /*fc*/) = 0;
+    //! Number of captures currently being collected
+    virtual int active_captures() const = 0;
+    virtual void set_cfar_mode(cfar_mode_t /*mode*/) = 0;
+    virtual void set_cfar_threshold_db(float /*db*/) = 0;
+    //! Current correlator noise floor estimate, linear
+    virtual float noise_floor() const = 0;
+    virtual void set_coarse_threshold(float /*threshold*/) = 0;
+    //! Fraction of the correlator blocks skipped by the coarse stage so far
+    virtual double skipped_fraction() const = 0;
+    //! Threshold crossings suppressed by the holdoff so far
+    virtual uint64_t suppressed_triggers() const = 0;
+    virtual void set_holdoff(int /*holdoff*/) = 0;
+    /*!
+     * \brief Absolute time of item 0, used until an rx_time tag comes in.
+     *
+     * With rx_time tags, or an epoch, the PDU metadata has "rx_time", the
+     * TOA as a (uint64 seconds, double fraction) tuple like the tag.
+     */
+    virtual void set_epoch(uint64_t /*secs*/, double /*frac*/) = 0;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_ZC_DETECTOR_H */
@@ -0,0 +1,91 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_ARENA_H
+#define INCLUDED_DRONEID_ARENA_H
+
+#include <volk/volk.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Bump allocator over one aligned block, for the scratch of a decoder.
+ *
+ * Everything allocated before mark() lives as long as the arena, reset()
+ * hands out the rest again from the mark. Every buffer starts on a cache
+ * line so the SIMD kernels and FFTW see the same alignment from volk_malloc()
+ * each time. Nothing is constructed or destroyed, the memory is zeroed once.
+ *
+ * A default constructed arena has no memory and only counts, carving a
+ * layout out of it first gives the size to construct the real one with.
+ */
+class arena
+{
+private:
+    static constexpr size_t ALIGN = 64;
+    uint8_t* m_base;
+    size_t m_size;
+    size_t m_used;
+    size_t m_mark;
+
+public:
+    arena() : m_base(nullptr), m_size(0), m_used(0), m_mark(0) {}
+    explicit arena(size_t bytes)
+        : m_base(static_cast<uint8_t*>(volk_malloc(bytes, ALIGN))),
+          m_size(bytes),
+          m_used(0),
+          m_mark(0)
+    {
+        if (!m_base) {
+            throw std::bad_alloc();
+        }
+        memset(m_base, 0, bytes);
+    }
+    ~arena() { volk_free(m_base); }
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+    arena& operator=(arena&& a) noexcept
+    {
+        std::swap(m_base, a.m_base);
+        std::swap(m_size, a.m_size);
+        std::swap(m_used, a.m_used);
+        std::swap(m_mark, a.m_mark);
+        return *this;
+    }
+
+    // num Ts, nullptr when only counting
+    template <typename T>
+    T* alloc(size_t num)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena doesn't run destructors");
+        const size_t bytes = (num * sizeof(T) + ALIGN - 1) / ALIGN * ALIGN;
+        if (m_base && m_used + bytes > m_size) {
+            throw std::length_error("arena: out of space");
+        }
+        T* p = m_base ? reinterpret_cast<T*>(m_base + m_used) : nullptr;
+        m_used += bytes;
+        return p;
+    }
+
+    void mark() { m_mark = m_used; }
+    void reset() { m_used = m_mark; }
+    size_t used() const { return m_used; }
+    size_t size() const { return m_size; }
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_ARENA_H */
@@ -0,0 +1,484 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "burst_decoder.h"
+#include "decoder_tables.h"
+#include "polyphase_resampler.h"
+#include "qpsk_demap.h"
+#include <gnuradio/droneid/fft_plans.h>
+#include <gnuradio/droneid/utilities.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+extern "C" {
+#include <turbofec/rate_match.h>
+#include <turbofec/turbo.h>
+}
+
+namespace gr {
+namespace droneid {
+
+namespace {
+
+// Other rates, e.g. 50 Msps, are resampled to 15.36 Msps per capture.
+// Only the window decode() can look at is resampled, the burst and a
+// symbol either side, so m_buf has a fixed size whatever the capture.
+class resampling_decoder : public burst_decoder
+{
+private:
+    typedef ofdm_geometry<1024> geometry;
+    static constexpr int32_t MARGIN = geometry::SYMBOL;
+    static constexpr int32_t WINDOW = geometry::BURST_LENGTH + 2 * MARGIN;
+
+    polyphase_resampler m_resampler;
+    burst_decoder_impl<1024> m_decoder;
+    // Input samples of the window, and before zc4 in it
+    int32_t m_window;
+    int32_t m_before;
+    volk::vector<gr_complex> m_buf;
+
+public:
+    resampling_decoder(int interpolation, int decimation, double samp_rate)
+        : m_resampler(interpolation,
+                      decimation,
+                      resampler_taps(interpolation, decimation, samp_rate),
+                      0.0),
+          m_window(((int64_t)WINDOW * decimation + interpolation - 1) / interpolation),
+          m_before(((int64_t)(geometry::ZC4_OFFSET + MARGIN) * decimation + interpolation - 1) /
+                   interpolation),
+          m_buf(m_resampler.burst_outputs(m_window))
+    {
+    }
+
+    bool decode(const gr_complex* x, int32_t num, int32_t zc4, decode_result& r) override
+    {
+        const int64_t l = m_resampler.interpolation();
+        const int64_t m = m_resampler.decimation();
+        const int32_t first = std::max(zc4 - m_before, 0);
+        if (first >= num) {
+            return false;
+        }
+        // Zero phase, sample j is at input time first + jM / L
+        const int nout = m_resampler.resample_burst(
+            x + first, std::min(num - first, m_window), m_buf.data());
+        if (!m_decoder.decode(m_buf.data(), nout, ((zc4 - first) * l + m / 2) / m, r)) {
+            return false;
+        }
+        // Back to input samples, the fraction stays in sto
+        const double start = first + (r.burst_start + (double)r.sto) * m / l;
+        r.burst_start = std::lround(start);
+        r.sto = start - r.burst_start;
+        return true;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<burst_decoder> burst_decoder::make(double samp_rate)
+{
+    // Rates to the Hz, the ratio below is of whole numbers too
+    int64_t l = std::llround(ofdm_geometry<1024>::SAMP_RATE);
+    int64_t m = std::llround(samp_rate);
+    if (m == l) {
+        return std::make_unique<burst_decoder_impl<1024>>();
+    }
+    if (m == 2 * l) {
+        return std::make_unique<burst_decoder_impl<2048>>();
+    }
+    if (m == 4 * l) {
+        return std::make_unique<burst_decoder_impl<4096>>();
+    }
+    reduce_ratio(l, m);
+    if (l > MAX_INTERPOLATION) {
+        throw std::invalid_argument("burst_decoder: no resampling ratio for the sample rate");
+    }
+    return std::make_unique<resampling_decoder>(l, m, samp_rate);
+}
+
+template <int N>
+burst_decoder_impl<N>::burst_decoder_impl()
+    : m_zc4_inv(zc_reciprocal(ZC_ROOT_SYMBOL_4)),
+      m_zc6_inv(zc_reciprocal(ZC_ROOT_SYMBOL_6)),
+      m_fft(fft_plans::get(N, 1, N, N, true)),
+      m_tfwd(fft_plans::get(2 * N, 1, 2 * N, 2 * N, true)),
+      m_trev(fft_plans::get(2 * N, 1, 2 * N, 2 * N, false)),
+      // All 8 symbols in one go, each FFT window short_cp into its symbol
+      m_plan(fft_plans::get(N, NUM_SYMBOLS, SYMBOL, N, true)),
+      m_rate_matcher(lte_rate_matcher_alloc()),
+      m_tdec(alloc_tdec())
+{
+    // Size the arena by carving the layout out of a counting one
+    arena layout;
+    carve_tables(layout);
+    carve_scratch(layout);
+    m_arena = arena(layout.used());
+    carve_tables(m_arena);
+    m_arena.mark();
+    carve_scratch(m_arena);
+
+    // The scratch is free until the first decode()
+    std::fill(m_tin, m_tin + 2 * N, gr_complex(0));
+    int k = 0;
+    for (const auto& run : RUNS) {
+        for (int i = 0; i < run.num; ++i, ++k) {
+            m_tin[run.bin + i] = std::conj(m_zc4_inv[k]);
+        }
+    }
+    for (int i = 0; i < CODED_BITS; ++i) {
+        m_descramble[i] = golden_bit(i) ? 1.f : -1.f;
+    }
+
+    // Time domain ZC symbol 4, zero padded to 2n and back to frequency
+    std::shared_ptr<const fft_plan> ifft = fft_plans::get(N, 1, N, N, false);
+    ifft->execute(m_tin, m_tout);
+    std::fill(m_tin, m_tin + 2 * N, gr_complex(0));
+    memcpy(m_tin, m_tout, N * sizeof(gr_complex));
+    m_tfwd->execute(m_tin, m_timing_ref);
+}
+
+template <int N>
+burst_decoder_impl<N>::~burst_decoder_impl()
+{
+    lte_rate_matcher_free(m_rate_matcher);
+    free_tdec(m_tdec);
+}
+
+template <int N>
+void burst_decoder_impl<N>::carve_tables(arena& a)
+{
+    m_timing_ref = a.alloc<gr_complex>(2 * N);
+    m_descramble = a.alloc<float>(CODED_BITS);
+    for (auto& w : m_weights) {
+        w = a.alloc<gr_complex>(DATA_CARRIERS);
+    }
+}
+
+template <int N>
+void burst_decoder_impl<N>::carve_scratch(arena& a)
+{
+    m_burst = a.alloc<gr_complex>(BURST_LEN);
+    m_spec = a.alloc<gr_complex>(NUM_SYMBOLS * N);
+    m_sym = a.alloc<gr_complex>(N);
+    m_tin = a.alloc<gr_complex>(2 * N);
+    m_tout = a.alloc<gr_complex>(2 * N);
+    m_h4 = a.alloc<gr_complex>(2 * DATA_CARRIERS);
+    m_h6 = m_h4 + DATA_CARRIERS;
+    m_h6h4 = a.alloc<gr_complex>(DATA_CARRIERS);
+    m_mag = a.alloc<float>(N + 1);
+    m_soft = a.alloc<int8_t>(CODED_BITS);
+    for (auto& d : m_turbo_in) {
+        d = a.alloc<int8_t>(TURBO_BITS);
+    }
+}
+
+template <int N>
+void burst_decoder_impl<N>::derotate(const gr_complex* x, gr_complex* out, int32_t num, float cfo)
+{
+    const float w = -2.f * M_PI * cfo / N;
+    m_rotator.set_phase(gr_complex(1, 0));
+    m_rotator.set_phase_incr(gr_complex(std::cos(w), std::sin(w)));
+    m_rotator.rotateN(out, x, num);
+}
+
+template <int N>
+uint32_t burst_decoder_impl<N>::crc(const uint8_t* data, int num) const
+{
+    uint32_t c = 0;
+    for (int i = 0; i < num; ++i) {
+        c = CRC24_TABLE[data[i] ^ (uint8_t)(c >> 16)] ^ (c << 8);
+    }
+    return c & 0xFFFFFF;
+}
+
+template <int N>
+float burst_decoder_impl<N>::estimate_cfo(const gr_complex* x,
+                                          int32_t b,
+                                          int32_t zc4,
+                                          float& delay)
+{
+    // CP against the end of the symbol, the last short_cp samples of the long CP
+    gr_complex acc = 0;
+    for (int s = 0; s < NUM_SYMBOLS; ++s) {
+        const int32_t cp = b + s * SYMBOL + (s == NUM_SYMBOLS - 1 ? LONG_CP - CP : 0);
+        gr_complex c;
+        volk_32fc_x2_conjugate_dot_prod_32fc(&c, x + cp, x + cp + N, CP);
+        acc += c;
+    }
+    const float ffo = -std::arg(acc) / (2.f * M_PI);
+
+    // Integer part, the DC null of the ZC symbols with the fractional part
+    // removed. Their spectra wait in the slots of symbols 2 and 4 of m_spec
+    // until the batched FFT.
+    std::fill(m_mag, m_mag + 2 * IFO_RANGE + 1, 0.f);
+    for (int z = 0; z < 2; ++z) {
+        gr_complex* y = m_spec + (2 + 2 * z) * N;
+        derotate(x + zc4 + z * ZC_DISTANCE, m_sym, N, ffo);
+        m_fft->execute(m_sym, y);
+        for (int d = -IFO_RANGE; d <= IFO_RANGE; ++d) {
+            m_mag[d + IFO_RANGE] += std::norm(y[(d + N) % N]);
+        }
+    }
+    const int32_t ifo = std::min_element(m_mag, m_mag + 2 * IFO_RANGE + 1) - m_mag - IFO_RANGE;
+
+    // The subcarriers are ifo bins up, over the ZC sequences what is left is
+    // the slope of the delay in the FFT windows
+    for (int z = 0; z < 2; ++z) {
+        const gr_complex* y = m_spec + (2 + 2 * z) * N;
+        const gr_complex* inv = z == 0 ? m_zc4_inv : m_zc6_inv;
+        gr_complex* h = m_h4 + z * DATA_CARRIERS;
+        int k = 0;
+        for (const auto& run : RUNS) {
+            for (int i = 0; i < run.num; ++i, ++k) {
+                h[k] = y[(run.bin + i + ifo) & (N - 1)] * inv[k];
+            }
+        }
+    }
+    delay = align(m_h4, 2);
+    return ifo + ffo;
+}
+
+template <int N>
+int32_t burst_decoder_impl<N>::zc4_lag()
+{
+    // c[l] = sum_k x[l + k] conj(zc4[k]) of the 2n samples in m_tin, valid
+    // for l = 0..n
+    m_tfwd->execute(m_tin, m_tout);
+    volk_32fc_x2_multiply_conjugate_32fc(m_tin, m_tout, m_timing_ref, 2 * N);
+    m_trev->execute(m_tin, m_tout);
+    volk_32fc_magnitude_squared_32f(m_mag, m_tout, N + 1);
+    uint32_t lag;
+    volk_32f_index_max_32u(&lag, m_mag, N + 1);
+    return lag;
+}
+
+template <int N>
+void burst_decoder_impl<N>::ramp(const gr_complex* h, gr_complex* out, float delay)
+{
+    // h exp(j 2pi f delay / N) at subcarrier frequency f, out may be h
+    const float w = 2.f * M_PI * delay / N;
+    int k = 0;
+    for (const auto& run : RUNS) {
+        const int f = run.bin < N / 2 ? run.bin : run.bin - N;
+        m_rotator.set_phase(gr_complex(std::cos(w * f), std::sin(w * f)));
+        m_rotator.set_phase_incr(gr_complex(std::cos(w), std::sin(w)));
+        m_rotator.rotateN(out + k, h + k, run.num);
+        k += run.num;
+    }
+}
+
+template <int N>
+float burst_decoder_impl<N>::align(gr_complex* h, int num)
+{
+    // A delay of d samples in the window is h ~ exp(-j 2pi f d / N), every
+    // product h[k + l] conj(h[k]) has the phase -2pi l d / N. Each lag takes
+    // out what it finds, the next one only sees the rest. num estimates
+    // of DATA_CARRIERS each with the same delay are taken together.
+    float delay = 0.f;
+    for (const int lag : SLOPE_LAGS) {
+        gr_complex acc = 0;
+        for (int i = 0; i < num; ++i) {
+            int k = i * DATA_CARRIERS;
+            for (const auto& run : RUNS) {
+                gr_complex c;
+                volk_32fc_x2_conjugate_dot_prod_32fc(&c, h + k + lag, h + k, run.num - lag);
+                acc += c;
+                k += run.num;
+            }
+        }
+        const float d = -std::arg(acc) * N / (2.f * M_PI * lag);
+        for (int i = 0; i < num; ++i) {
+            ramp(h + i * DATA_CARRIERS, h + i * DATA_CARRIERS, d);
+        }
+        delay += d;
+    }
+
+    // Last the two runs against each other, RUN_SPAN carriers apart
+    gr_complex acc = 0;
+    for (int i = 0; i < num; ++i) {
+        const gr_complex* lo = h + i * DATA_CARRIERS;
+        const gr_complex* hi = lo + RUNS[0].num;
+        acc += std::accumulate(hi, hi + RUNS[1].num, gr_complex(0)) *
+               std::conj(std::accumulate(lo, lo + RUNS[0].num, gr_complex(0)));
+    }
+    const float d = -std::arg(acc) * N / (2.f * M_PI * RUN_SPAN);
+    for (int i = 0; i < num; ++i) {
+        ramp(h + i * DATA_CARRIERS, h + i * DATA_CARRIERS, d);
+    }
+    return delay + d;
+}
+
+template <int N>
+void burst_decoder_impl<N>::smooth(const gr_complex* h, gr_complex* w)
+{
+    constexpr float TAPS[SMOOTH_TAPS] = { .2f, .3f, .4f, .5f, .4f, .3f, .2f };
+    constexpr float GAIN = 1.f / 2.3f;
+    constexpr int HALF = SMOOTH_TAPS / 2;
+    std::copy(h, h + HALF, w);
+    std::copy(h + DATA_CARRIERS - HALF, h + DATA_CARRIERS, w + DATA_CARRIERS - HALF);
+    for (int k = HALF; k < DATA_CARRIERS - HALF; ++k) {
+        gr_complex acc = 0;
+        for (int j = 0; j < SMOOTH_TAPS; ++j) {
+            acc += TAPS[j] * h[k - HALF + j];
+        }
+        w[k] = GAIN * acc;
+    }
+}
+
+template <int N>
+void burst_decoder_impl<N>::estimate_channel(decode_result& r)
+{
+    // The ZC symbols are 2 and 4 counting from 0, the data symbols the others
+    const gr_complex* y4 = m_spec + 2 * N;
+    const gr_complex* y6 = m_spec + 4 * N;
+    int k = 0;
+    for (const auto& run : RUNS) {
+        volk_32fc_x2_multiply_32fc(m_h4 + k, y4 + run.bin, m_zc4_inv + k, run.num);
+        volk_32fc_x2_multiply_32fc(m_h6 + k, y6 + run.bin, m_zc6_inv + k, run.num);
+        k += run.num;
+    }
+
+    // The delay both ZC symbols have in common, then the drift between
+    // them from h6 conj(h4) where the channel drops out. The estimates are
+    // left without either.
+    const float delay = align(m_h4, 2);
+    volk_32fc_x2_multiply_conjugate_32fc(m_h6h4, m_h6, m_h4, DATA_CARRIERS);
+    const float drift = align(m_h6h4, 1);
+    ramp(m_h4, m_h4, -.5f * drift);
+    ramp(m_h6, m_h6, .5f * drift);
+
+    // The channel is taken as static over the two ZC symbols, the
+    // difference of the estimates is noise of twice the variance
+    float diff = 0.f;
+    float sum = 0.f;
+    for (int k = 0; k < DATA_CARRIERS; ++k) {
+        diff += std::norm(m_h4[k] - m_h6[k]);
+        sum += std::norm(m_h4[k] + m_h6[k]);
+    }
+    const float noise = std::max(diff / (2 * DATA_CARRIERS), 1e-20f);
+    const float signal = std::max(sum / (4 * DATA_CARRIERS) - noise / 2, 1e-20f);
+
+    // Symbols before the first ZC symbol use its estimate, the one in
+    // between the mean of both and the rest the second one
+    gr_complex* const before = m_weights[0];
+    gr_complex* const between = m_weights[2];
+    gr_complex* const after = m_weights[NUM_DATA - 1];
+    smooth(m_h4, before);
+    smooth(m_h6, after);
+    for (int k = 0; k < DATA_CARRIERS; ++k) {
+        between[k] = .5f * (before[k] + after[k]);
+    }
+    // Unit power QPSK at the power of the ZC subcarriers, an I or Q value
+    // of Re(y conj(h)) has the LLR 2 sqrt(2) Re(y conj(h)) / noise
+    const gr_complex gain = 2.f * (float)M_SQRT2 * LLR_STEPS / noise;
+    for (gr_complex* w : { before, between, after }) {
+        for (int k = 0; k < DATA_CARRIERS; ++k) {
+            w[k] = std::conj(w[k]) * gain;
+        }
+    }
+
+    // Symbol s is delay + (s - 3) drift / 2 late in its window, the last
+    // one long_cp - short_cp more as its window starts that early in the CP
+    const auto timing = [&](int s) {
+        return delay + .5f * (s - 3) * drift + (s == NUM_SYMBOLS - 1 ? LONG_CP - CP : 0);
+    };
+    ramp(before, m_weights[1], timing(DATA_SYMBOLS[1]));
+    ramp(before, before, timing(DATA_SYMBOLS[0]));
+    ramp(between, between, timing(DATA_SYMBOLS[2]));
+    ramp(after, m_weights[3], timing(DATA_SYMBOLS[3]));
+    ramp(after, m_weights[4], timing(DATA_SYMBOLS[4]));
+    ramp(after, after, timing(DATA_SYMBOLS[5]));
+
+    r.sto = timing(0);
+    r.sco = 1e6f * drift / ZC_DISTANCE;
+    r.snr_db = 10.f * std::log10(signal / noise);
+}
+
+template <int N>
+void burst_decoder_impl<N>::demap()
+{
+    // The weights carry the LLR scaling, equalizing and demapping is one pass
+    int bit = 0;
+    for (int i = 0; i < NUM_DATA; ++i) {
+        const gr_complex* y = m_spec + DATA_SYMBOLS[i] * N;
+        int k = 0;
+        for (const auto& run : RUNS) {
+            qpsk_demap(y + run.bin,
+                       m_weights[i] + k,
+                       m_descramble + bit,
+                       1.f,
+                       m_soft + bit,
+                       run.num);
+            k += run.num;
+            bit += 2 * run.num;
+        }
+    }
+}
+
+template <int N>
+bool burst_decoder_impl<N>::decode(const gr_complex* x, int32_t num, int32_t zc4, decode_result& r)
+{
+    m_arena.reset();
+    carve_scratch(m_arena);
+
+    // Coarse timing first, the CP based CFO estimate needs it to within the
+    // CP and the ZC correlation peak survives a fractional CFO
+    if (zc4 - N / 2 < 0 || zc4 + 3 * N / 2 > num) {
+        return false;
+    }
+    memcpy(m_tin, x + zc4 - N / 2, 2 * N * sizeof(gr_complex));
+    zc4 += zc4_lag() - N / 2;
+    const int32_t b0 = zc4 - ZC4;
+    if (b0 < 0 || b0 + BURST_LEN > num) {
+        return false;
+    }
+    float delay;
+    const float cfo = estimate_cfo(x, b0, zc4, delay);
+
+    // The whole samples of the ZC slope move the FFT windows, the fraction
+    // and the SCO go into the equalizer weights
+    const int32_t b = b0 + std::lround(delay);
+    if (b < 0 || b + BURST_LEN > num) {
+        return false;
+    }
+    derotate(x + b, m_burst, BURST_LEN, cfo);
+    m_plan->execute(m_burst + CP, m_spec);
+    estimate_channel(r);
+    demap();
+
+    lte_rate_matcher_io io;
+    io.D = TURBO_BITS;
+    io.E = CODED_BITS;
+    for (int i = 0; i < 3; ++i) {
+        io.d[i] = m_turbo_in[i];
+    }
+    io.e = m_soft;
+    lte_rate_match_rv(m_rate_matcher, &io, 0);
+    lte_turbo_decode(m_tdec,
+                     8 * decode_result::FRAME_BYTES,
+                     TURBO_ITERATIONS,
+                     r.frame.data(),
+                     m_turbo_in[0],
+                     m_turbo_in[1],
+                     m_turbo_in[2]);
+
+    r.crc = crc(r.frame.data(), decode_result::FRAME_BYTES);
+    r.crc_ok = r.crc == 0;
+    r.cfo = cfo;
+    r.burst_start = b;
+    return true;
+}
+
+template class burst_decoder_impl<1024>;
+template class burst_decoder_impl<2048>;
+template class burst_decoder_impl<4096>;
+
+} // namespace droneid
+} // namespace gr
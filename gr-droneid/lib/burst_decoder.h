@@ -0,0 +1,193 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_BURST_DECODER_H
+#define INCLUDED_DRONEID_BURST_DECODER_H
+
+#include "arena.h"
+#include <gnuradio/blocks/rotator.h>
+#include <gnuradio/droneid/fft_plans.h>
+#include <gnuradio/droneid/utilities.h>
+#include <gnuradio/gr_complex.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+
+struct lte_rate_matcher;
+struct tdecoder;
+
+namespace gr {
+namespace droneid {
+
+struct decode_result {
+    static constexpr int FRAME_BYTES = 176;
+    bool crc_ok;
+    uint32_t crc;          // CRC24 remainder over the frame, 0 if it's good
+    float cfo;             // in subcarriers
+    float snr_db;          // per subcarrier, from the two ZC symbols
+    int32_t burst_start;   // in the capture
+    float sto;             // the burst starts this many samples after burst_start
+    float sco;             // sampling clock offset in ppm, from the two ZC symbols
+    std::array<uint8_t, FRAME_BYTES> frame;
+};
+
+/*
+ * DroneID burst decoder, the steps in cpp/decoder.cpp from the IFO on.
+ *
+ *   - CFO, fractional part from the CP of all 8 symbols and integer part
+ *     from the DC null of the two ZC symbols, removed from the capture
+ *   - coarse timing from one ZC correlation around the nominal position,
+ *     then the STO to a fraction of a sample and the SCO from the phase
+ *     slope of the two ZC symbols across the subcarriers
+ *   - one batched FFT of the 8 symbols, channel estimate from the two ZC
+ *     symbols, the timing of each symbol a phase ramp in its equalizer
+ *     weights instead of an interpolator
+ *   - noise from the two ZC symbols, int8 LLRs of the 6 data symbols
+ *     scaled by it and descrambled with the golden sequence
+ *   - rate matching and turbo decoding with turbofec, CRC24
+ *
+ * All buffers and FFT plans are set up in the constructor, the buffers in
+ * one aligned arena whose per burst part decode() resets. decode() doesn't
+ * touch the heap. Not thread safe, one instance per thread.
+ */
+class burst_decoder
+{
+private:
+    // Largest L of an L / M resampling to 15.36 Msps, in branches of taps
+    static constexpr int64_t MAX_INTERPOLATION = 1024;
+
+public:
+    virtual ~burst_decoder() {}
+
+    /*
+     * Decode the burst in the num samples at x. zc4 is where the FFT window
+     * of the first ZC symbol is expected, i.e. pre_trigger of the trigger
+     * blocks, it is searched for half a symbol either side. Returns false
+     * if the burst isn't in the capture, r is only complete on true.
+     */
+    virtual bool decode(const gr_complex* x, int32_t num, int32_t zc4, decode_result& r) = 0;
+
+    /*
+     * The decoder for captures at samp_rate. 15.36, 30.72 and 61.44 Msps
+     * are demodulated directly, other rates are resampled to 15.36 Msps
+     * first. Throws std::invalid_argument for a rate that doesn't reduce
+     * to a small enough ratio, or is too low for the channel.
+     */
+    static std::unique_ptr<burst_decoder> make(double samp_rate);
+};
+
+// A run of data subcarriers in consecutive FFT bins
+struct carrier_run {
+    int32_t bin;
+    int32_t num;
+};
+
+/*
+ * The decoder for an N point FFT, the geometry is ofdm_geometry<N>. The
+ * capture is demodulated at its own rate, the data subcarriers are picked
+ * out of the N bins and the rest of the band is never looked at.
+ * Instantiated for 1024, 2048 and 4096.
+ */
+template <int N>
+class burst_decoder_impl : public burst_decoder
+{
+private:
+    typedef ofdm_geometry<N> geometry;
+    static constexpr int32_t CP = geometry::SHORT_CP;
+    static constexpr int32_t LONG_CP = geometry::LONG_CP;
+    static constexpr int32_t SYMBOL = geometry::SYMBOL;
+    static constexpr int32_t ZC4 = geometry::ZC4_OFFSET;
+    static constexpr int32_t ZC_DISTANCE = geometry::ZC_DISTANCE;
+    static constexpr int32_t BURST_LEN = geometry::BURST_LENGTH;
+    static constexpr int TURBO_BITS = 8 * decode_result::FRAME_BYTES + 4;
+    static constexpr int TURBO_ITERATIONS = 4;
+    static constexpr int NUM_DATA = 6;
+    static constexpr std::array<int, NUM_DATA> DATA_SYMBOLS = { { 0, 1, 3, 5, 6, 7 } };
+    // Carrier lags of the phase slope estimate, each well inside the
+    // ambiguity of N / 2 lag samples left by the one before
+    static constexpr std::array<int, 3> SLOPE_LAGS = { { 1, 8, 64 } };
+    // Carriers between the centres of the two runs, the last slope lag
+    static constexpr int RUN_SPAN = geometry::HIGH_BIN - geometry::LOW_BIN + N;
+    // Integer CFO search, subcarriers either side of DC
+    static constexpr int IFO_RANGE = 20;
+    // 7 tap channel estimate smoother from cpp/decoder.cpp
+    static constexpr int SMOOTH_TAPS = 7;
+    // int8 LLR steps per natural log likelihood unit, saturating at 63
+    // takes an LLR of about 16
+    static constexpr float LLR_STEPS = 4.f;
+    // The data subcarriers are two runs of FFT bins, negative frequencies
+    // first, so the fftshift() is just where they start
+    static constexpr std::array<carrier_run, 2> RUNS = {
+        { { geometry::LOW_BIN, DATA_CARRIERS / 2 }, { geometry::HIGH_BIN, DATA_CARRIERS / 2 } }
+    };
+
+    // Shared 1 / ZC tables, see decoder_tables.h
+    const gr_complex* m_zc4_inv;
+    const gr_complex* m_zc6_inv;
+    gr::blocks::rotator m_rotator;
+    // All FFTs from fft_plans, shared by the decoders of a process and
+    // planned with its wisdom. One ZC symbol, the timing correlation both
+    // ways, and the 8 symbols in one batch.
+    std::shared_ptr<const fft_plan> m_fft;
+    std::shared_ptr<const fft_plan> m_tfwd;
+    std::shared_ptr<const fft_plan> m_trev;
+    std::shared_ptr<const fft_plan> m_plan;
+    lte_rate_matcher* m_rate_matcher;
+    tdecoder* m_tdec;
+
+    // All other buffers are in the arena, see carve_tables() and
+    // carve_scratch()
+    arena m_arena;
+    // FFT(2n) of the zero padded ZC symbol 4 for the timing search
+    gr_complex* m_timing_ref;
+    // Descrambling signs of the coded bits, see qpsk_demap()
+    float* m_descramble;
+    // Equalizer weights of the data symbols, conj(h) / noise with the
+    // timing of the symbol as a phase ramp
+    std::array<gr_complex*, NUM_DATA> m_weights;
+    // Per burst from here. The CFO corrected burst and the spectra of its
+    // 8 symbols, one batched FFT
+    gr_complex* m_burst;
+    gr_complex* m_spec;
+    // FFT input of one ZC symbol, and of the timing correlation with its
+    // output
+    gr_complex* m_sym;
+    gr_complex* m_tin;
+    gr_complex* m_tout;
+    // Channel estimates of the ZC symbols, m_h6 right after m_h4
+    gr_complex* m_h4;
+    gr_complex* m_h6;
+    gr_complex* m_h6h4;
+    float* m_mag;
+    int8_t* m_soft;
+    std::array<int8_t*, 3> m_turbo_in;
+
+    void carve_tables(arena& a);
+    void carve_scratch(arena& a);
+    void derotate(const gr_complex* x, gr_complex* out, int32_t num, float cfo);
+    float estimate_cfo(const gr_complex* x, int32_t b, int32_t zc4, float& delay);
+    int32_t zc4_lag();
+    void ramp(const gr_complex* h, gr_complex* out, float delay);
+    float align(gr_complex* h, int num);
+    void estimate_channel(decode_result& r);
+    void smooth(const gr_complex* h, gr_complex* w);
+    void demap();
+    uint32_t crc(const uint8_t* data, int num) const;
+
+public:
+    burst_decoder_impl();
+    ~burst_decoder_impl() override;
+    burst_decoder_impl(const burst_decoder_impl&) = delete;
+    burst_decoder_impl& operator=(const burst_decoder_impl&) = delete;
+
+    bool decode(const gr_complex* x, int32_t num, int32_t zc4, decode_result& r) override;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_BURST_DECODER_H */
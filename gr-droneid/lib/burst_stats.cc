@@ -0,0 +1,185 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "burst_stats.h"
+#include <gnuradio/droneid/utilities.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DRONEID_STATS_X86
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define DRONEID_STATS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace gr {
+namespace droneid {
+
+static void measure_power_generic(const gr_complex* x, int num, float clip, power_stats* out)
+{
+    const float* f = reinterpret_cast<const float*>(x);
+    float sum = 0.f;
+    float peak = 0.f;
+    int32_t clipped = 0;
+    for (int i = 0; i < num; ++i) {
+        const float re = f[2 * i];
+        const float im = f[2 * i + 1];
+        const float p = re * re + im * im;
+        sum += p;
+        peak = std::max(peak, p);
+        clipped += (std::fabs(re) >= clip) + (std::fabs(im) >= clip);
+    }
+    out->sum = sum;
+    out->peak = peak;
+    out->clipped = clipped;
+}
+
+#ifdef DRONEID_STATS_X86
+
+__attribute__((target("avx2,popcnt"))) static void
+measure_power_avx2(const gr_complex* x, int num, float clip, power_stats* out)
+{
+    const float* f = reinterpret_cast<const float*>(x);
+    const __m256 c = _mm256_set1_ps(clip);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 acc = _mm256_setzero_ps();
+    __m256 pk = _mm256_setzero_ps();
+    int32_t clipped = 0;
+    int i = 0;
+    // 8 samples per iteration
+    for (; i + 8 <= num; i += 8) {
+        const __m256 v0 = _mm256_loadu_ps(f + 2 * i);
+        const __m256 v1 = _mm256_loadu_ps(f + 2 * i + 8);
+        const __m256 s0 = _mm256_mul_ps(v0, v0);
+        const __m256 s1 = _mm256_mul_ps(v1, v1);
+        acc = _mm256_add_ps(acc, _mm256_add_ps(s0, s1));
+        // |x|^2 of all 8, lane order doesn't matter for the max
+        pk = _mm256_max_ps(pk, _mm256_hadd_ps(s0, s1));
+        const int m0 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_and_ps(v0, abs_mask), c, _CMP_GE_OQ));
+        const int m1 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_and_ps(v1, abs_mask), c, _CMP_GE_OQ));
+        clipped += __builtin_popcount(m0 | (m1 << 8));
+    }
+    float a[8], p[8];
+    _mm256_storeu_ps(a, acc);
+    _mm256_storeu_ps(p, pk);
+    power_stats tail;
+    measure_power_generic(x + i, num - i, clip, &tail);
+    out->sum = tail.sum;
+    out->peak = tail.peak;
+    for (int k = 0; k < 8; ++k) {
+        out->sum += a[k];
+        out->peak = std::max(out->peak, p[k]);
+    }
+    out->clipped = clipped + tail.clipped;
+}
+
+#endif /* DRONEID_STATS_X86 */
+
+#ifdef DRONEID_STATS_NEON
+
+static void measure_power_neon(const gr_complex* x, int num, float clip, power_stats* out)
+{
+    const float* f = reinterpret_cast<const float*>(x);
+    const float32x4_t c = vdupq_n_f32(clip);
+    float32x4_t acc = vdupq_n_f32(0.f);
+    float32x4_t pk = vdupq_n_f32(0.f);
+    int32x4_t cnt = vdupq_n_s32(0);
+    int i = 0;
+    // 4 samples per iteration
+    for (; i + 4 <= num; i += 4) {
+        const float32x4_t v0 = vld1q_f32(f + 2 * i);
+        const float32x4_t v1 = vld1q_f32(f + 2 * i + 4);
+        const float32x4_t s0 = vmulq_f32(v0, v0);
+        const float32x4_t s1 = vmulq_f32(v1, v1);
+        acc = vaddq_f32(acc, vaddq_f32(s0, s1));
+        pk = vmaxq_f32(pk, vpaddq_f32(s0, s1));
+        // The masks are all ones, i.e. -1 per clipped value
+        cnt = vsubq_s32(cnt, vreinterpretq_s32_u32(vcageq_f32(v0, c)));
+        cnt = vsubq_s32(cnt, vreinterpretq_s32_u32(vcageq_f32(v1, c)));
+    }
+    power_stats tail;
+    measure_power_generic(x + i, num - i, clip, &tail);
+    out->sum = tail.sum + vaddvq_f32(acc);
+    out->peak = std::max(tail.peak, vmaxvq_f32(pk));
+    out->clipped = tail.clipped + vaddvq_s32(cnt);
+}
+
+#endif /* DRONEID_STATS_NEON */
+
+std::vector<burst_stats_arch> burst_stats_archs()
+{
+    std::vector<burst_stats_arch> archs;
+    archs.push_back({ "generic", measure_power_generic });
+#ifdef DRONEID_STATS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        archs.push_back({ "avx2", measure_power_avx2 });
+    }
+#endif
+#ifdef DRONEID_STATS_NEON
+    archs.push_back({ "neon", measure_power_neon });
+#endif
+    return archs;
+}
+
+void measure_power(const gr_complex* x, int num, float clip, power_stats* out)
+{
+    static const burst_stats_arch arch = burst_stats_archs().back();
+    arch.measure(x, num, clip, out);
+}
+
+burst_meter::burst_meter(double samp_rate, int pre_trigger, int zc4, int capture_size)
+{
+    m_has_burst = zc4 >= 0;
+    if (!m_has_burst) {
+        // Only the clipping, over everything
+        m_burst_start = 0;
+        m_burst_len = capture_size;
+        m_noise_start = 0;
+        m_noise_len = 0;
+        return;
+    }
+    const int32_t burst_start = pre_trigger - zc4;
+    const int32_t burst_end = burst_start + (int32_t)burst_length(samp_rate);
+    m_burst_start = std::max(burst_start, 0);
+    m_burst_len = std::max(std::min(burst_end, capture_size) - m_burst_start, 0);
+
+    // A quarter symbol of noise right before the burst
+    m_noise_len = fft_size(samp_rate) / 4;
+    m_noise_start = burst_start - m_noise_len;
+    if (m_noise_start < 0) {
+        m_noise_len = 0;
+    }
+}
+
+burst_stats burst_meter::measure(const gr_complex* capture) const
+{
+    burst_stats s = {};
+    power_stats p;
+    if (m_burst_len) {
+        measure_power(capture + m_burst_start, m_burst_len, CLIP_LEVEL, &p);
+        s.clipped = p.clipped;
+        if (m_has_burst) {
+            s.has_burst = true;
+            s.power = p.sum / m_burst_len;
+            s.papr_db =
+                10.f * std::log10(std::max(p.peak, 1e-20f) / std::max(s.power, 1e-20f));
+        }
+    }
+    if (m_noise_len) {
+        measure_power(capture + m_noise_start, m_noise_len, CLIP_LEVEL, &p);
+        s.has_noise = true;
+        s.noise = std::max(p.sum / m_noise_len, 1e-20f);
+        s.snr_db = 10.f * std::log10(std::max((s.power - s.noise) / s.noise, 1e-10f));
+    }
+    return s;
+}
+
+} // namespace droneid
+} // namespace gr
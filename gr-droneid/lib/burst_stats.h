@@ -0,0 +1,83 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_BURST_STATS_H
+#define INCLUDED_DRONEID_BURST_STATS_H
+
+#include <gnuradio/gr_complex.h>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+struct power_stats {
+    float sum;       // sum of |x|^2
+    float peak;      // max of |x|^2
+    int32_t clipped; // I and Q values at or beyond the clip level
+};
+
+/*
+ * Sum, peak and clip count of num samples in one pass, nothing is written
+ * but out. Dispatched on first use like find_first_above().
+ */
+void measure_power(const gr_complex* x, int num, float clip, power_stats* out);
+
+typedef void (*measure_power_t)(const gr_complex*, int, float, power_stats*);
+
+struct burst_stats_arch {
+    const char* name;
+    measure_power_t measure;
+};
+
+/*
+ * All implementations the running CPU supports, generic first and the
+ * dispatched one last.
+ */
+std::vector<burst_stats_arch> burst_stats_archs();
+
+struct burst_stats {
+    bool has_burst;  // the burst window is known and inside the capture
+    bool has_noise;  // the noise window is inside the capture
+    float noise;     // mean |x|^2 before the burst
+    float power;     // mean |x|^2 over the burst
+    float snr_db;    // power ratio, 10 log10((power - noise) / noise)
+    float papr_db;
+    int32_t clipped;
+};
+
+/*
+ * Noise and burst statistics of a capture.
+ *
+ * The trigger sample is pre_trigger samples into the capture and zc4
+ * samples into the burst, zc4_offset() when it is the FFT window of the
+ * first ZC symbol. The burst and the noise window right before it follow
+ * from the frame geometry in utilities.h, clipped to the capture. A trigger
+ * that doesn't know where in the burst it fires passes a negative zc4, then
+ * only the clipped count is measured, over the whole capture. Everything
+ * is set up in the constructor, measure() only reads.
+ */
+class burst_meter
+{
+private:
+    // bladeRF SC16 Q11 full scale
+    static constexpr float CLIP_LEVEL = 2047.f / 2048.f;
+    bool m_has_burst;
+    int32_t m_noise_start;
+    int32_t m_noise_len;
+    int32_t m_burst_start;
+    int32_t m_burst_len;
+
+public:
+    burst_meter(double samp_rate, int pre_trigger, int zc4, int capture_size);
+    burst_stats measure(const gr_complex* capture) const;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_BURST_STATS_H */
@@ -0,0 +1,104 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "capture_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace gr {
+namespace droneid {
+
+capture_engine::capture_engine(int pre_trigger, int chunk_size, int max_captures, int peak_window)
+    : m_pre_trigger(pre_trigger),
+      m_size(pre_trigger + chunk_size),
+      m_peak_window(peak_window),
+      // Room for a few rounds of captures held downstream before it stops growing
+      m_pool(pre_trigger + chunk_size, max_captures, POOL_ROUNDS * max_captures),
+      m_ring(max_captures),
+      m_head(0),
+      m_count(0),
+      m_dropped(0)
+{
+    if (peak_window < 1) {
+        throw std::invalid_argument("capture_engine: peak_window must be at least 1");
+    }
+}
+
+capture_engine::capture* capture_engine::start(const gr_complex* in, int avail, uint64_t trigger_item, float prev)
+{
+    if (m_count == m_ring.size()) {
+        m_dropped++;
+        return nullptr;
+    }
+    capture& c = m_ring[(m_head + m_count) % m_ring.size()];
+    c.vector = m_pool.acquire(c.data);
+    c.trigger_item = trigger_item;
+    c.peak_item = trigger_item;
+    c.peak_next = trigger_item;
+    c.peak[0] = c.peak[1] = c.peak[2] = std::numeric_limits<float>::lowest();
+    c.last = prev;
+    c.collected = std::min(avail, m_size);
+    memcpy(c.data, in, c.collected * sizeof(gr_complex));
+    m_count++;
+    return &c;
+}
+
+void capture_engine::feed(const gr_complex* in, int num)
+{
+    for (size_t i = 0; i < m_count; ++i) {
+        capture& c = m_ring[(m_head + i) % m_ring.size()];
+        const int32_t n = std::min(num, m_size - c.collected);
+        memcpy(c.data + c.collected, in, n * sizeof(gr_complex));
+        c.collected += n;
+    }
+}
+
+void capture_engine::track(const float* t, int num, uint64_t first)
+{
+    for (size_t i = 0; i < m_count; ++i) {
+        capture& c = m_ring[(m_head + i) % m_ring.size()];
+        // The window plus one sample for the right neighbour of the peak
+        const uint64_t end = c.trigger_item + m_peak_window;
+        uint64_t n = std::max(c.peak_next, first);
+        for (; n < first + num && n <= end; ++n) {
+            const float v = t[n - first];
+            if (n == c.peak_item + 1) {
+                c.peak[2] = v;
+            }
+            if (n < end && v > c.peak[1]) {
+                c.peak[0] = c.last;
+                c.peak[1] = v;
+                c.peak_item = n;
+            }
+            c.last = v;
+        }
+        c.peak_next = std::max(c.peak_next, n);
+    }
+}
+
+capture_engine::capture* capture_engine::completed()
+{
+    if (m_count && m_ring[m_head].collected == m_size &&
+        m_ring[m_head].peak_next > m_ring[m_head].trigger_item + m_peak_window) {
+        return &m_ring[m_head];
+    }
+    return nullptr;
+}
+
+void capture_engine::release()
+{
+    // Let go of the vector so it returns to the pool when downstream is done
+    m_ring[m_head].vector = pmt::PMT_NIL;
+    m_ring[m_head].data = nullptr;
+    m_head = (m_head + 1) % m_ring.size();
+    m_count--;
+}
+
+} // namespace droneid
+} // namespace gr
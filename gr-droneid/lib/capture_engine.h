@@ -0,0 +1,94 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_CAPTURE_ENGINE_H
+#define INCLUDED_DRONEID_CAPTURE_ENGINE_H
+
+#include "pdu_pool.h"
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Bookkeeping for the captures a trigger block has in flight.
+ *
+ * Every capture is pre_trigger + chunk_size samples long and is written into
+ * a pooled PDU vector. All captures have the same length, so they complete
+ * in the order they were started and live in a FIFO ring.
+ *
+ * Each capture also looks for the correlator peak in the peak_window samples
+ * from the trigger sample on, and keeps the samples around it for the
+ * sub-sample TOA. The search follows the correlator across work() calls and
+ * a capture is only complete once its peak is known.
+ */
+class capture_engine
+{
+public:
+    struct capture {
+        pmt::pmt_t vector;
+        gr_complex* data;
+        int32_t collected;
+        uint64_t trigger_item;
+        uint64_t peak_item;
+        uint64_t peak_next; // next correlator item the peak search wants
+        float peak[3];      // correlator at peak_item - 1, peak_item and peak_item + 1
+        float last;
+        // Channel center frequency and the absolute time of trigger_item,
+        // stamped by the owner at the trigger
+        float fc;
+        bool timed;
+        uint64_t secs;
+        double frac;
+        double rate;
+    };
+
+private:
+    static constexpr int POOL_ROUNDS = 4;
+    int32_t m_pre_trigger;
+    int32_t m_size;
+    int32_t m_peak_window;
+    pdu_pool m_pool;
+    std::vector<capture> m_ring;
+    size_t m_head;
+    size_t m_count;
+    uint64_t m_dropped;
+
+public:
+    capture_engine(int pre_trigger, int chunk_size, int max_captures, int peak_window);
+
+    /*
+     * Start a capture. in points at sample trigger - pre_trigger and avail
+     * samples can be read from there, prev is the correlator sample before
+     * the trigger. Returns the new capture, or nullptr and counts a drop if
+     * max_captures are already in flight.
+     */
+    capture* start(const gr_complex* in, int avail, uint64_t trigger_item, float prev);
+    // Append the num new samples of this work() call to every open capture
+    void feed(const gr_complex* in, int num);
+    /*
+     * Run the peak searches over num correlator samples from item first on.
+     * Samples a search has already seen are skipped, so overlapping calls
+     * are fine.
+     */
+    void track(const float* t, int num, uint64_t first);
+    // Oldest capture if it is complete, nullptr otherwise
+    capture* completed();
+    // Drop the oldest capture after it has been published
+    void release();
+
+    int32_t size() const { return m_size; }
+    int32_t pre_trigger() const { return m_pre_trigger; }
+    int active() const { return (int)m_count; }
+    uint64_t dropped() const { return m_dropped; }
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_CAPTURE_ENGINE_H */
@@ -0,0 +1,233 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "capture_publisher.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace gr {
+namespace droneid {
+
+capture_publisher::capture_publisher(gr::basic_block* block,
+                                     float fc,
+                                     float threshold,
+                                     float cfar_threshold_db,
+                                     int chunk_size,
+                                     int pre_trigger,
+                                     int zc4,
+                                     double samp_rate,
+                                     int max_captures,
+                                     int holdoff,
+                                     int peak_window)
+    : m_block(block),
+      m_port(pmt::mp("pdu")),
+      m_pre_trigger(pre_trigger),
+      m_fc(fc),
+      m_thr(threshold),
+      m_holdoff(holdoff),
+      m_holdoff_until(0),
+      m_suppressed(0),
+      m_captures(pre_trigger, chunk_size, max_captures, peak_window),
+      m_meter(samp_rate, pre_trigger, zc4, pre_trigger + chunk_size),
+      m_clock(samp_rate),
+      m_out(nullptr),
+      m_out_space(0),
+      m_produced(0),
+      m_out_item(0),
+      m_out_pos(0)
+{
+    set_cfar_threshold_db(cfar_threshold_db);
+    m_block->message_port_register_out(m_port);
+}
+
+void capture_publisher::set_cfar_threshold_db(float db)
+{
+    m_cfar_gain = std::pow(10.f, db / 10.f);
+}
+
+float capture_publisher::threshold(const cfar_estimator& e) const
+{
+    if (e.mode() == CFAR_OFF) {
+        return m_thr;
+    }
+    // No trigger before the first noise cell is in
+    return e.ready() ? m_cfar_gain * e.noise() : std::numeric_limits<float>::max();
+}
+
+void capture_publisher::begin(gr_complex* out, int space, uint64_t out_item)
+{
+    m_out = out;
+    m_out_space = space;
+    m_out_item = out_item;
+    m_produced = 0;
+    m_out_tags.clear();
+}
+
+void capture_publisher::update(const std::vector<tag_t>& tags)
+{
+    // A channelizer upstream tags the channel center frequency, a source
+    // the time and rate
+    static const pmt::pmt_t fc = pmt::mp("fc");
+    static const pmt::pmt_t rx_time = pmt::mp("rx_time");
+    static const pmt::pmt_t rx_rate = pmt::mp("rx_rate");
+
+    for (const auto& tag : tags) {
+        if (pmt::eq(tag.key, fc) || pmt::eq(tag.key, rx_time) || pmt::eq(tag.key, rx_rate)) {
+            m_tags.push_back(tag);
+        }
+    }
+    std::stable_sort(m_tags.begin(), m_tags.end(), sample_clock::order);
+}
+
+void capture_publisher::advance(uint64_t item)
+{
+    static const pmt::pmt_t fc = pmt::mp("fc");
+
+    auto it = m_tags.begin();
+    for (; it != m_tags.end() && it->offset < item; ++it) {
+        if (pmt::eq(it->key, fc)) {
+            m_fc = pmt::to_float(it->value);
+        } else {
+            m_clock.apply(*it);
+        }
+    }
+    m_tags.erase(m_tags.begin(), it);
+}
+
+bool capture_publisher::trigger(const gr_complex* in,
+                                int avail,
+                                uint64_t trigger_item,
+                                float prev)
+{
+    if (trigger_item < m_holdoff_until) {
+        // Side lobe or multipath of a burst that is already captured
+        m_suppressed++;
+        return false;
+    }
+    m_holdoff_until = trigger_item + m_holdoff;
+
+    // The tags up to the trigger, not the ones later in the call
+    advance(trigger_item + 1);
+    capture_engine::capture* c = m_captures.start(in, avail, trigger_item, prev);
+    if (c) {
+        c->fc = m_fc;
+        c->timed = m_clock.valid();
+        c->rate = m_clock.rate();
+        if (c->timed) {
+            m_clock.time_at(trigger_item, 0., c->secs, c->frac);
+        }
+    }
+    return true;
+}
+
+float capture_publisher::toa(const float* y)
+{
+    // Vertex of the parabola through y[0], y[1], y[2], relative to y[0]
+    const float a = .5f * (y[0] - y[2]) + y[1] - y[0];
+    if (a <= 0.f) {
+        return 1.f;
+    }
+    const float b = y[1] - y[0] + a;
+    return .5 * b / a;
+}
+
+void capture_publisher::for_each_meta(const capture_engine::capture& c, const meta_fn& add)
+{
+    add("type", pmt::mp("dji droneid"));
+    add("size", pmt::mp(m_captures.size()));
+    add("pre_trigger", pmt::mp(m_pre_trigger));
+
+    const burst_stats st = m_meter.measure(c.data);
+    if (st.has_noise) {
+        add("noise", pmt::mp(st.noise));
+        add("snr", pmt::mp(st.snr_db));
+    }
+    if (st.has_burst) {
+        add("power", pmt::mp(st.power));
+        add("papr", pmt::mp(st.papr_db));
+    }
+    add("clipped", pmt::mp(st.clipped));
+    add("fc", pmt::mp(c.fc));
+    add("captures", pmt::mp(m_captures.active()));
+
+    // toa() is relative to the sample before the peak
+    float t_frac = toa(c.peak);
+    uint64_t t_int = c.peak_item - 1;
+    if (t_frac >= 1.f) {
+        t_frac -= 1.f;
+        t_int += 1;
+    }
+    add("toa_frac", pmt::mp(t_frac));
+    add("toa_int", pmt::mp(t_int));
+    if (c.timed) {
+        // From the time stamped at the trigger, the peak is a few samples on
+        sample_clock clock(c.rate);
+        clock.set_time(c.trigger_item, c.secs, c.frac);
+        uint64_t secs;
+        double frac;
+        clock.time_at(t_int, t_frac, secs, frac);
+        add("rx_time", pmt::make_tuple(pmt::from_uint64(secs), pmt::from_double(frac)));
+    }
+    if (m_extra) {
+        m_extra(add);
+    }
+}
+
+void capture_publisher::send_message(const capture_engine::capture& c)
+{
+    pmt::pmt_t meta = pmt::make_dict();
+    for_each_meta(c, [&meta](const char* key, const pmt::pmt_t& value) {
+        meta = pmt::dict_add(meta, pmt::mp(key), value);
+    });
+
+    // The capture was written straight into the pooled vector, no copy
+    m_block->message_port_pub(m_port, pmt::cons(meta, c.vector));
+}
+
+bool capture_publisher::write_stream(const capture_engine::capture& c)
+{
+    if (m_out_pos == 0) {
+        const uint64_t item = m_out_item + m_produced;
+        const auto add = [this, item](const char* key, const pmt::pmt_t& value) {
+            tag_t tag;
+            tag.offset = item;
+            tag.key = pmt::mp(key);
+            tag.value = value;
+            m_out_tags.push_back(tag);
+        };
+        add("packet_len", pmt::from_long(m_captures.size()));
+        for_each_meta(c, add);
+    }
+    const int32_t n = std::min(m_captures.size() - m_out_pos, m_out_space - m_produced);
+    memcpy(m_out + m_produced, c.data + m_out_pos, n * sizeof(gr_complex));
+    m_produced += n;
+    m_out_pos += n;
+    if (m_out_pos < m_captures.size()) {
+        return false;
+    }
+    m_out_pos = 0;
+    return true;
+}
+
+bool capture_publisher::publish()
+{
+    while (auto c = m_captures.completed()) {
+        if (!m_out) {
+            send_message(*c);
+        } else if (m_produced == m_out_space || !write_stream(*c)) {
+            // Output full, the rest goes out in the next call
+            return false;
+        }
+        m_captures.release();
+    }
+    return true;
+}
+
+} // namespace droneid
+} // namespace gr
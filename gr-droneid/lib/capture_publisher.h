@@ -0,0 +1,138 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_CAPTURE_PUBLISHER_H
+#define INCLUDED_DRONEID_CAPTURE_PUBLISHER_H
+
+#include "burst_stats.h"
+#include "capture_engine.h"
+#include "cfar_estimator.h"
+#include "sample_clock.h"
+#include <gnuradio/basic_block.h>
+#include <gnuradio/tags.h>
+#include <functional>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Everything a trigger block does after its detector fires, shared by
+ * trigger_impl and zc_detector_impl.
+ *
+ * The thresholds from the fixed level or the CFAR noise floor, the holdoff
+ * after a trigger, the captures in flight, their metadata with the TOA and
+ * the absolute time, and publishing them as PDUs or on the stream output.
+ *
+ * The block runs its detector and hands the triggers to trigger(), and
+ * advance()s past the items it has scanned. The
+ * stream output tags are collected in tags() for the block to add, as
+ * add_item_tag() is the block's.
+ */
+class capture_publisher
+{
+public:
+    typedef std::function<void(const char*, const pmt::pmt_t&)> meta_fn;
+    // Metadata a block adds to every burst after the common keys
+    typedef std::function<void(const meta_fn&)> extra_fn;
+
+private:
+    gr::basic_block* m_block;
+    const pmt::pmt_t m_port;
+    int32_t m_pre_trigger;
+    float m_fc;
+    float m_thr;
+    float m_cfar_gain;
+    int32_t m_holdoff;
+    // No new capture before this item
+    uint64_t m_holdoff_until;
+    uint64_t m_suppressed;
+    capture_engine m_captures;
+    burst_meter m_meter;
+    sample_clock m_clock;
+    // fc, rx_time and rx_rate tags not applied yet, in sample_clock::order()
+    std::vector<tag_t> m_tags;
+    extra_fn m_extra;
+    // Stream output of the current work() call, nullptr if not connected
+    gr_complex* m_out;
+    int m_out_space;
+    int m_produced;
+    uint64_t m_out_item;
+    // Samples of the oldest completed capture already on the stream output
+    int32_t m_out_pos;
+    std::vector<tag_t> m_out_tags;
+
+    void for_each_meta(const capture_engine::capture& c, const meta_fn& add);
+    void send_message(const capture_engine::capture& c);
+    bool write_stream(const capture_engine::capture& c);
+    static float toa(const float* y);
+
+public:
+    // zc4 is where in the burst the trigger fires, see burst_meter
+    capture_publisher(gr::basic_block* block,
+                      float fc,
+                      float threshold,
+                      float cfar_threshold_db,
+                      int chunk_size,
+                      int pre_trigger,
+                      int zc4,
+                      double samp_rate,
+                      int max_captures,
+                      int holdoff,
+                      int peak_window);
+
+    void set_extra_meta(extra_fn extra) { m_extra = std::move(extra); }
+    void set_threshold(float t) { m_thr = t; }
+    void set_fc(float f) { m_fc = f; }
+    void set_cfar_threshold_db(float db);
+    void set_holdoff(int holdoff) { m_holdoff = holdoff; }
+    void set_epoch(uint64_t secs, double frac) { m_clock.set_epoch(secs, frac); }
+    int active() const { return m_captures.active(); }
+    int32_t capture_size() const { return m_captures.size(); }
+    uint64_t suppressed() const { return m_suppressed; }
+
+    // Fixed or CFAR threshold of a detector stream with noise estimator e
+    float threshold(const cfar_estimator& e) const;
+
+    /*
+     * Start of a work() call. out is the stream output, nullptr if it isn't
+     * connected, with room for space samples from item out_item on.
+     */
+    void begin(gr_complex* out, int space, uint64_t out_item);
+    /*
+     * fc, rx_time and rx_rate tags of the input. They are queued and take
+     * effect at their item, as the triggers get there.
+     */
+    void update(const std::vector<tag_t>& tags);
+    // Apply the queued tags before item
+    void advance(uint64_t item);
+    // Append the new samples of this call to the open captures
+    void feed(const gr_complex* in, int num) { m_captures.feed(in, num); }
+    // Correlator samples for the peak searches, see capture_engine::track()
+    void track(const float* t, int num, uint64_t first) { m_captures.track(t, num, first); }
+    /*
+     * A threshold crossing at trigger_item. Inside the holdoff of the last
+     * trigger it is counted as suppressed, otherwise a capture starts, see
+     * capture_engine::start(), stamped with the fc and the time of
+     * trigger_item. False if it was suppressed.
+     */
+    bool trigger(const gr_complex* in, int avail, uint64_t trigger_item, float prev);
+    /*
+     * Publish the completed captures in order. False if the stream output
+     * is full and holds some back, they go first in the next call.
+     */
+    bool publish();
+    // Samples written to the stream output in this call
+    int produced() const { return m_produced; }
+    // Tags for the stream output written in this call
+    const std::vector<tag_t>& tags() const { return m_out_tags; }
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_CAPTURE_PUBLISHER_H */
@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "cfar_estimator.h"
+#include <volk/volk.h>
+#include <algorithm>
+
+namespace gr {
+namespace droneid {
+
+cfar_estimator::cfar_estimator(int cell_size, int num_cells, cfar_mode_t mode)
+    : m_cell_size(cell_size),
+      m_mode(mode),
+      m_cells(num_cells, 0.f),
+      m_sorted(num_cells, 0.f),
+      m_next(0),
+      m_count(0),
+      m_sum(0.),
+      m_noise(0.f)
+{
+}
+
+void cfar_estimator::set_mode(cfar_mode_t mode)
+{
+    m_mode = mode;
+}
+
+void cfar_estimator::update(const float* x)
+{
+    float acc;
+    volk_32f_accumulator_s32f(&acc, x, m_cell_size);
+    const float mean = acc / m_cell_size;
+
+    // Running sum, the oldest cell leaves as the new one comes in
+    m_sum += mean - m_cells[m_next];
+    m_cells[m_next] = mean;
+    m_next = (m_next + 1) % m_cells.size();
+    m_count = std::min(m_count + 1, m_cells.size());
+
+    if (m_mode == CFAR_OS) {
+        // Upper quartile of the cells, a few bursts among them don't move it
+        std::copy(m_cells.begin(), m_cells.begin() + m_count, m_sorted.begin());
+        auto k = m_sorted.begin() + (3 * m_count) / 4;
+        std::nth_element(m_sorted.begin(), k, m_sorted.begin() + m_count);
+        m_noise = *k;
+    } else {
+        m_noise = m_sum / m_count;
+    }
+}
+
+} // namespace droneid
+} // namespace gr
@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_CFAR_ESTIMATOR_H
+#define INCLUDED_DRONEID_CFAR_ESTIMATOR_H
+
+#include <gnuradio/droneid/cfar.h>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Running correlator noise floor for the CFAR trigger modes.
+ *
+ * The input is split in cells of cell_size samples. Each cell costs one
+ * SIMD accumulate, the cell means of the last num_cells cells are kept in a
+ * ring with a running sum. The estimate only covers past cells, so a burst
+ * never raises the threshold it is tested against.
+ */
+class cfar_estimator
+{
+private:
+    int m_cell_size;
+    cfar_mode_t m_mode;
+    std::vector<float> m_cells;
+    std::vector<float> m_sorted;
+    size_t m_next;
+    size_t m_count;
+    double m_sum;
+    float m_noise;
+
+public:
+    cfar_estimator(int cell_size, int num_cells, cfar_mode_t mode = CFAR_CA);
+
+    void set_mode(cfar_mode_t mode);
+    cfar_mode_t mode() const { return m_mode; }
+    int cell_size() const { return m_cell_size; }
+    // Add the next cell, x holds cell_size samples
+    void update(const float* x);
+    // Mean correlator level, 0 until the first cell is in
+    float noise() const { return m_noise; }
+    bool ready() const { return m_count > 0; }
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_CFAR_ESTIMATOR_H */
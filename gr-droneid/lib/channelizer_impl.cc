@@ -0,0 +1,179 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "channelizer_impl.h"
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/io_signature.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace droneid {
+
+channelizer::sptr channelizer::make(double samp_rate,
+                                    float center_freq,
+                                    const std::vector<float>& channel_freqs,
+                                    int decimation,
+                                    int num_bins,
+                                    const std::vector<float>& taps)
+{
+    return gnuradio::make_block_sptr<channelizer_impl>(
+        samp_rate, center_freq, channel_freqs, decimation, num_bins, taps);
+}
+
+
+/*
+ * The private constructor
+ */
+channelizer_impl::channelizer_impl(double samp_rate,
+                                   float center_freq,
+                                   const std::vector<float>& channel_freqs,
+                                   int decimation,
+                                   int num_bins,
+                                   const std::vector<float>& taps)
+    : gr::sync_decimator("channelizer",
+                         gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                         gr::io_signature::make(1, -1, sizeof(gr_complex)),
+                         decimation)
+{
+    if (channel_freqs.empty()) {
+        throw std::invalid_argument("channelizer: no channels");
+    }
+    if (decimation < 1 || num_bins < decimation || num_bins % decimation) {
+        throw std::invalid_argument("channelizer: num_bins must be a multiple of decimation");
+    }
+    m_samp_rate = samp_rate;
+    m_center_freq = center_freq;
+    m_channel_freqs = channel_freqs;
+    m_decim = decimation;
+    m_bins = num_bins;
+
+    std::vector<float> h = taps;
+    if (h.empty()) {
+        h = gr::filter::firdes::low_pass(1.0,
+                                         samp_rate,
+                                         .5 * (PASS_EDGE + STOP_EDGE),
+                                         STOP_EDGE - PASS_EDGE,
+                                         gr::fft::window::WIN_HAMMING);
+    }
+    // Whole rows of m_bins taps, the zero padding goes in front of the oldest sample
+    m_ntaps = (h.size() + m_bins - 1) / m_bins * m_bins;
+    h.resize(m_ntaps, 0.f);
+    m_taps.resize(m_ntaps);
+    for (int i = 0; i < m_ntaps; ++i) {
+        m_taps[i] = h[m_ntaps - 1 - i];
+    }
+    m_prod.resize(m_ntaps);
+    m_fft = std::make_unique<gr::fft::fft_complex_rev>(m_bins);
+
+    m_bin.resize(m_channel_freqs.size());
+    m_rotators.resize(m_channel_freqs.size());
+    retune();
+    set_history(m_ntaps);
+    // Tags are passed on in work(), rx_rate has to be divided down
+    set_tag_propagation_policy(TPP_DONT);
+}
+
+/*
+ * Our virtual destructor.
+ */
+channelizer_impl::~channelizer_impl() {}
+
+bool channelizer_impl::check_topology(int ninputs, int noutputs)
+{
+    return ninputs == 1 && noutputs == (int)m_channel_freqs.size();
+}
+
+void channelizer_impl::set_center_freq(float center_freq)
+{
+    // work() runs with the set lock held
+    gr::thread::scoped_lock lock(d_setlock);
+    m_center_freq = center_freq;
+    retune();
+}
+
+void channelizer_impl::retune()
+{
+    for (size_t c = 0; c < m_channel_freqs.size(); ++c) {
+        const double offset = (m_channel_freqs[c] - m_center_freq) * 1.e6;
+        // Nearest bin, the rest is a rotation at the output rate
+        const int k = std::lround(offset / m_samp_rate * m_bins);
+        m_bin[c] = ((k % m_bins) + m_bins) % m_bins;
+        // Bin k needs exp(-j2pi k m D / M) when the filterbank is oversampled,
+        // together with the residual that is the full channel offset
+        const double w = -2. * M_PI * offset * m_decim / m_samp_rate;
+        m_rotators[c].set_phase_incr(gr_complex(std::cos(w), std::sin(w)));
+    }
+    m_tag_pending = true;
+}
+
+void channelizer_impl::propagate_tags(int noutput_items, int noutputs)
+{
+    std::vector<tag_t> tags;
+    get_tags_in_range(tags, 0, nitems_read(0), nitems_read(0) + (uint64_t)noutput_items * m_decim);
+    for (const auto& tag : tags) {
+        // Each channel has its own fc tag
+        if (pmt::eq(tag.key, pmt::mp("fc"))) {
+            continue;
+        }
+        pmt::pmt_t value = tag.value;
+        if (pmt::eq(tag.key, pmt::mp("rx_rate"))) {
+            value = pmt::from_double(pmt::to_double(value) / m_decim);
+        } else if (pmt::eq(tag.key, pmt::mp("rx_time")) && pmt::is_tuple(value)) {
+            // Output item n is input item n * D, the tag moves back by the
+            // remainder and its time with it
+            const int64_t rem = tag.offset % m_decim;
+            const double frac = pmt::to_double(pmt::tuple_ref(value, 1)) - rem / m_samp_rate;
+            const double whole = std::floor(frac);
+            value = pmt::make_tuple(
+                pmt::from_uint64(pmt::to_uint64(pmt::tuple_ref(value, 0)) + (int64_t)whole),
+                pmt::from_double(frac - whole));
+        }
+        for (int c = 0; c < noutputs; ++c) {
+            add_item_tag(c, tag.offset / m_decim, tag.key, value, tag.srcid);
+        }
+    }
+}
+
+int channelizer_impl::work(int noutput_items,
+                           gr_vector_const_void_star& input_items,
+                           gr_vector_void_star& output_items)
+{
+    auto in = static_cast<const gr_complex*>(input_items[0]);
+
+    if (m_tag_pending) {
+        for (size_t c = 0; c < output_items.size(); ++c) {
+            add_item_tag(c, nitems_written(c), pmt::mp("fc"), pmt::mp(m_channel_freqs[c]));
+        }
+        m_tag_pending = false;
+    }
+    propagate_tags(noutput_items, output_items.size());
+
+    const int32_t rows = m_ntaps / m_bins;
+    float* prod = reinterpret_cast<float*>(m_prod.data());
+    gr_complex* branches = m_fft->get_inbuf();
+    const gr_complex* bins = m_fft->get_outbuf();
+    for (int j = 0; j < noutput_items; ++j) {
+        // Every tap is used once per output, whatever the number of channels
+        volk_32fc_32f_multiply_32fc(m_prod.data(), in + j * m_decim, m_taps.data(), m_ntaps);
+        for (int32_t p = 1; p < rows; ++p) {
+            volk_32f_x2_add_32f(prod, prod, prod + 2 * p * m_bins, 2 * m_bins);
+        }
+        // The taps are reversed, branch r ends up at m_bins - 1 - r
+        for (int32_t r = 0; r < m_bins; ++r) {
+            branches[r] = m_prod[m_bins - 1 - r];
+        }
+        m_fft->execute();
+        for (size_t c = 0; c < output_items.size(); ++c) {
+            static_cast<gr_complex*>(output_items[c])[j] = m_rotators[c].rotate(bins[m_bin[c]]);
+        }
+    }
+    return noutput_items;
+}
+
+} /* namespace droneid */
+} /* namespace gr */
@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_CHANNELIZER_IMPL_H
+#define INCLUDED_DRONEID_CHANNELIZER_IMPL_H
+
+#include <gnuradio/droneid/channelizer.h>
+#include <gnuradio/blocks/rotator.h>
+#include <gnuradio/fft/fft.h>
+#include <volk/volk.h>
+#include <volk/volk_alloc.hh>
+#include <memory>
+
+namespace gr {
+namespace droneid {
+
+class channelizer_impl : public channelizer
+{
+private:
+    // DroneID channel passband and stopband edges from python/sigproc.py
+    static constexpr double PASS_EDGE = 5.5e6;
+    static constexpr double STOP_EDGE = 8.0e6;
+    double m_samp_rate;
+    float m_center_freq;
+    std::vector<float> m_channel_freqs;
+    int32_t m_decim;
+    int32_t m_bins;
+    int32_t m_ntaps;  // prototype length, padded to a multiple of m_bins
+    // Prototype taps in reverse order, so they line up with the input window
+    volk::vector<float> m_taps;
+    volk::vector<gr_complex> m_prod;
+    std::unique_ptr<gr::fft::fft_complex_rev> m_fft;
+    // Bin and output rate rotator per channel
+    std::vector<int> m_bin;
+    std::vector<gr::blocks::rotator> m_rotators;
+    bool m_tag_pending;
+    void retune();
+    void propagate_tags(int noutput_items, int noutputs);
+public:
+    channelizer_impl(double samp_rate,
+                     float center_freq,
+                     const std::vector<float>& channel_freqs,
+                     int decimation,
+                     int num_bins,
+                     const std::vector<float>& taps);
+    ~channelizer_impl();
+    void set_center_freq(float center_freq) override;
+    float center_freq() const override { return m_center_freq; }
+    std::vector<float> channel_freqs() const override { return m_channel_freqs; }
+    bool check_topology(int ninputs, int noutputs) override;
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_CHANNELIZER_IMPL_H */
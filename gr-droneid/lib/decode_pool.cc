@@ -0,0 +1,183 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "decode_pool.h"
+#include <stdexcept>
+
+namespace gr {
+namespace droneid {
+
+decode_pool::decode_pool(double samp_rate,
+                         int num_workers,
+                         size_t depth,
+                         decode_fn decode,
+                         publish_fn publish)
+    : m_decode(std::move(decode)),
+      m_publish(std::move(publish)),
+      m_next(0),
+      m_collect_next(0),
+      m_running(false),
+      m_workers_done(true),
+      m_dropped(0)
+{
+    if (num_workers < 1) {
+        throw std::invalid_argument("decode_pool: need at least one worker");
+    }
+    if (depth < 1) {
+        throw std::invalid_argument("decode_pool: depth must be at least 1");
+    }
+    for (int i = 0; i < num_workers; ++i) {
+        m_workers.push_back(std::make_unique<worker>(samp_rate, depth));
+    }
+}
+
+decode_pool::~decode_pool() { stop(); }
+
+void decode_pool::wake(std::mutex& m, std::condition_variable& cv)
+{
+    // Taking the lock orders the ring update before the sleeper's check
+    {
+        std::lock_guard<std::mutex> lock(m);
+    }
+    cv.notify_one();
+}
+
+void decode_pool::start()
+{
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    m_workers_done = false;
+    m_started = clock::now();
+    for (auto& w : m_workers) {
+        w->busy_ns = 0;
+        w->thread = std::thread([this, &w] { work(*w); });
+    }
+    m_collector = std::thread([this] { collect(); });
+}
+
+void decode_pool::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    for (auto& w : m_workers) {
+        wake(w->mutex, w->cv);
+    }
+    for (auto& w : m_workers) {
+        w->thread.join();
+    }
+    m_workers_done = true;
+    wake(m_collector_mutex, m_collector_cv);
+    m_collector.join();
+}
+
+bool decode_pool::submit(pmt::pmt_t msg)
+{
+    worker& w = *m_workers[m_next];
+    if (!w.jobs.push(std::move(msg))) {
+        m_dropped++;
+        return false;
+    }
+    m_next = (m_next + 1) % m_workers.size();
+    wake(w.mutex, w.cv);
+    return true;
+}
+
+void decode_pool::work(worker& w)
+{
+    pmt::pmt_t msg;
+    for (;;) {
+        if (!w.jobs.pop(msg)) {
+            // Leave only once the ring is empty, stop() waits for it
+            if (!m_running) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(w.mutex);
+            w.cv.wait(lock, [&] { return !w.jobs.empty() || !m_running; });
+            continue;
+        }
+
+        const auto t0 = clock::now();
+        pmt::pmt_t out;
+        try {
+            out = m_decode(*w.decoder, msg);
+        } catch (const std::exception&) {
+            // Keeps the slot, the collector expects a result for every job
+            out = pmt::PMT_NIL;
+        }
+        msg = pmt::pmt_t();
+        w.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0)
+                         .count();
+
+        // The collector drains in order, a full result ring means it is
+        // waiting on an earlier worker
+        while (!w.results.push(std::move(out))) {
+            std::unique_lock<std::mutex> lock(w.mutex);
+            w.cv.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        wake(m_collector_mutex, m_collector_cv);
+    }
+}
+
+void decode_pool::drain(size_t& next)
+{
+    pmt::pmt_t out;
+    for (;;) {
+        worker& w = *m_workers[next];
+        if (!w.results.pop(out)) {
+            return;
+        }
+        wake(w.mutex, w.cv);
+        next = (next + 1) % m_workers.size();
+        if (!pmt::eq(out, pmt::PMT_NIL)) {
+            m_publish(out);
+        }
+        out = pmt::pmt_t();
+    }
+}
+
+void decode_pool::collect()
+{
+    for (;;) {
+        drain(m_collect_next);
+        if (m_workers_done) {
+            // Every job has its result in a ring by now
+            drain(m_collect_next);
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_collector_mutex);
+        m_collector_cv.wait(lock, [&] {
+            return !m_workers[m_collect_next]->results.empty() || m_workers_done;
+        });
+    }
+}
+
+size_t decode_pool::queue_depth() const
+{
+    size_t depth = 0;
+    for (const auto& w : m_workers) {
+        depth += w->jobs.size();
+    }
+    return depth;
+}
+
+std::vector<float> decode_pool::utilisation() const
+{
+    std::vector<float> u;
+    const double elapsed =
+        std::chrono::duration<double, std::nano>(clock::now() - m_started).count();
+    for (const auto& w : m_workers) {
+        u.push_back(m_running && elapsed > 0 ? w->busy_ns / elapsed : 0.f);
+    }
+    return u;
+}
+
+} // namespace droneid
+} // namespace gr
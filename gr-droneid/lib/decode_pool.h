@@ -0,0 +1,116 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_DECODE_POOL_H
+#define INCLUDED_DRONEID_DECODE_POOL_H
+
+#include "burst_decoder.h"
+#include "spsc_ring.h"
+#include <pmt/pmt.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Fixed pool of decode threads, each with its own burst_decoder.
+ *
+ * submit() hands the PDUs to the workers round robin, through one SPSC job
+ * ring per worker, and the collector thread takes the results from the
+ * result rings in the same order. So frames come out in the order the
+ * captures came in without sequence numbers or a reorder buffer, a slow
+ * burst just holds back the ones behind it.
+ *
+ * The data path is lock free. The mutex and condition variable of a
+ * worker are only used to sleep on an empty ring and to wake it up, once
+ * per PDU.
+ *
+ * A PDU for a worker whose ring is full is dropped and counted, the
+ * caller, a message handler, never blocks.
+ */
+class decode_pool
+{
+public:
+    // Decode one PDU, return the PDU to publish or PMT_NIL. Called from
+    // all workers at once, with their own decoder.
+    typedef std::function<pmt::pmt_t(burst_decoder&, const pmt::pmt_t&)> decode_fn;
+    typedef std::function<void(const pmt::pmt_t&)> publish_fn;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct worker {
+        std::unique_ptr<burst_decoder> decoder;
+        spsc_ring<pmt::pmt_t> jobs;
+        spsc_ring<pmt::pmt_t> results;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<uint64_t> busy_ns{ 0 };
+        std::thread thread;
+
+        worker(double samp_rate, size_t depth)
+            : decoder(burst_decoder::make(samp_rate)), jobs(depth), results(depth)
+        {
+        }
+    };
+
+    const decode_fn m_decode;
+    const publish_fn m_publish;
+    std::vector<std::unique_ptr<worker>> m_workers;
+    // Next worker to submit to, only the submitting thread touches it
+    size_t m_next;
+    // Next worker to collect from, walks the workers like m_next
+    size_t m_collect_next;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_workers_done;
+    std::atomic<uint64_t> m_dropped;
+    clock::time_point m_started;
+    std::mutex m_collector_mutex;
+    std::condition_variable m_collector_cv;
+    std::thread m_collector;
+
+    static void wake(std::mutex& m, std::condition_variable& cv);
+    void work(worker& w);
+    void collect();
+    // Publish the results that are in order
+    void drain(size_t& next);
+
+public:
+    decode_pool(double samp_rate,
+                int num_workers,
+                size_t depth,
+                decode_fn decode,
+                publish_fn publish);
+    ~decode_pool();
+    decode_pool(const decode_pool&) = delete;
+    decode_pool& operator=(const decode_pool&) = delete;
+
+    void start();
+    // Decodes and publishes what was submitted before returning
+    void stop();
+
+    // False, and the PDU dropped, if its worker is full. One thread only.
+    bool submit(pmt::pmt_t msg);
+
+    // PDUs waiting for a worker
+    size_t queue_depth() const;
+    uint64_t dropped() const { return m_dropped; }
+    // Fraction of the time since start() each worker spent decoding
+    std::vector<float> utilisation() const;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_DECODE_POOL_H */
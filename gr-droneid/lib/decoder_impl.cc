@@ -0,0 +1,111 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "decoder_impl.h"
+#include <gnuradio/droneid/utilities.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+
+namespace gr {
+namespace droneid {
+
+decoder::sptr decoder::make(double samp_rate, bool crc_only, int threads, int queue_depth)
+{
+    return gnuradio::make_block_sptr<decoder_impl>(samp_rate, crc_only, threads, queue_depth);
+}
+
+decoder_impl::decoder_impl(double samp_rate, bool crc_only, int threads, int queue_depth)
+    : gr::block("decoder", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+      m_samp_rate(samp_rate),
+      m_crc_only(crc_only),
+      m_port(pmt::mp("pdu")),
+      m_ok(0),
+      m_failed(0),
+      m_pool(
+          samp_rate,
+          threads,
+          std::max(queue_depth, 1),
+          [this](burst_decoder& dec, const pmt::pmt_t& msg) { return decode(dec, msg); },
+          [this](const pmt::pmt_t& pdu) { message_port_pub(m_port, pdu); })
+{
+    message_port_register_in(m_port);
+    message_port_register_out(m_port);
+    set_msg_handler(m_port, [this](const pmt::pmt_t& msg) { this->handle(msg); });
+}
+
+decoder_impl::~decoder_impl() {}
+
+bool decoder_impl::start()
+{
+    m_pool.start();
+    return block::start();
+}
+
+bool decoder_impl::stop()
+{
+    m_pool.stop();
+    return block::stop();
+}
+
+void decoder_impl::handle(const pmt::pmt_t& msg)
+{
+    if (!pmt::is_pdu(msg) || !pmt::is_c32vector(pmt::cdr(msg))) {
+        return;
+    }
+    m_pool.submit(msg);
+}
+
+pmt::pmt_t decoder_impl::decode(burst_decoder& dec, const pmt::pmt_t& msg)
+{
+    pmt::pmt_t meta = pmt::car(msg);
+    size_t num;
+    const gr_complex* x = pmt::c32vector_elements(pmt::cdr(msg), num);
+
+    // A capture without pre_trigger, or one too short to hold the search
+    // around the first ZC symbol, is taken to start with the burst
+    int32_t zc4 = pmt::to_long(pmt::dict_ref(meta, pmt::mp("pre_trigger"), pmt::from_long(0)));
+    if (zc4 < (int32_t)fft_size(m_samp_rate) / 2) {
+        zc4 = zc4_offset(m_samp_rate);
+    }
+
+    decode_result r;
+    if (!dec.decode(x, num, zc4, r)) {
+        m_failed++;
+        return pmt::PMT_NIL;
+    }
+    if (!r.crc_ok) {
+        m_failed++;
+        if (m_crc_only) {
+            return pmt::PMT_NIL;
+        }
+    } else {
+        m_ok++;
+    }
+
+    meta = pmt::dict_add(meta, pmt::mp("size"), pmt::mp(decode_result::FRAME_BYTES));
+    meta = pmt::dict_add(meta, pmt::mp("crc_ok"), pmt::from_bool(r.crc_ok));
+    meta = pmt::dict_add(meta, pmt::mp("crc"), pmt::mp((long)r.crc));
+    meta = pmt::dict_add(meta, pmt::mp("cfo"), pmt::mp(r.cfo * CARRIER_SPACING));
+    meta = pmt::dict_add(meta, pmt::mp("frame_snr"), pmt::mp(r.snr_db));
+    meta = pmt::dict_add(meta, pmt::mp("burst_start"), pmt::mp(r.burst_start));
+    meta = pmt::dict_add(meta, pmt::mp("sto"), pmt::mp(r.sto));
+    meta = pmt::dict_add(meta, pmt::mp("sco"), pmt::mp(r.sco));
+    return pmt::cons(meta, pmt::init_u8vector(r.frame.size(), r.frame.data()));
+}
+
+uint64_t decoder_impl::frames_ok() const { return m_ok; }
+
+uint64_t decoder_impl::frames_failed() const { return m_failed; }
+
+uint64_t decoder_impl::frames_dropped() const { return m_pool.dropped(); }
+
+size_t decoder_impl::queue_depth() const { return m_pool.queue_depth(); }
+
+std::vector<float> decoder_impl::utilisation() const { return m_pool.utilisation(); }
+
+} /* namespace droneid */
+} /* namespace gr */
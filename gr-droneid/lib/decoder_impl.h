@@ -0,0 +1,47 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_DECODER_IMPL_H
+#define INCLUDED_DRONEID_DECODER_IMPL_H
+
+#include "decode_pool.h"
+#include <gnuradio/droneid/decoder.h>
+#include <atomic>
+
+namespace gr {
+namespace droneid {
+
+class decoder_impl : public decoder
+{
+private:
+    const double m_samp_rate;
+    const bool m_crc_only;
+    const pmt::pmt_t m_port;
+    std::atomic<uint64_t> m_ok;
+    std::atomic<uint64_t> m_failed;
+    decode_pool m_pool;
+
+    void handle(const pmt::pmt_t& msg);
+    // Runs on the pool threads
+    pmt::pmt_t decode(burst_decoder& dec, const pmt::pmt_t& msg);
+
+public:
+    decoder_impl(double samp_rate, bool crc_only, int threads, int queue_depth);
+    ~decoder_impl();
+    bool start() override;
+    bool stop() override;
+    uint64_t frames_ok() const override;
+    uint64_t frames_failed() const override;
+    uint64_t frames_dropped() const override;
+    size_t queue_depth() const override;
+    std::vector<float> utilisation() const override;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_DECODER_IMPL_H */
@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "decoder_tables.h"
+#include <gnuradio/droneid/utilities.h>
+#include <volk/volk_alloc.hh>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace droneid {
+
+// First and last words of golden_sequence() in cpp/decoder.cpp
+static_assert(GOLDEN_WORDS_TABLE[0] == 0x9E7B874B &&
+                  GOLDEN_WORDS_TABLE[GOLDEN_WORDS - 1] == 0x8CB785E2,
+              "Gold sequence doesn't match cpp/decoder.cpp");
+static_assert(CRC24_TABLE[1] == 0x864CFB && CRC24_TABLE[255] == 0xDD8538,
+              "CRC24 table doesn't match c/libdt.c");
+
+namespace {
+
+struct zc_tables {
+    volk::vector<gr_complex> symbol_4;
+    volk::vector<gr_complex> symbol_6;
+
+    static void make(int root, volk::vector<gr_complex>& r)
+    {
+        // Same sequence as utilities.create_zc_sequence()
+        for (int idx = 0; idx <= DATA_CARRIERS; ++idx) {
+            if (idx == DATA_CARRIERS / 2) {
+                continue;
+            }
+            const double x = M_PI * root * idx * (idx + 1.0) / (DATA_CARRIERS + 1);
+            r.push_back(gr_complex(std::cos(x), std::sin(x)));
+        }
+    }
+
+    zc_tables()
+    {
+        make(ZC_ROOT_SYMBOL_4, symbol_4);
+        make(ZC_ROOT_SYMBOL_6, symbol_6);
+    }
+};
+
+} // namespace
+
+const gr_complex* zc_reciprocal(int root)
+{
+    static const zc_tables tables;
+    switch (root) {
+    case ZC_ROOT_SYMBOL_4:
+        return tables.symbol_4.data();
+    case ZC_ROOT_SYMBOL_6:
+        return tables.symbol_6.data();
+    default:
+        throw std::invalid_argument("zc_reciprocal: unknown root");
+    }
+}
+
+} // namespace droneid
+} // namespace gr
@@ -0,0 +1,83 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_DECODER_TABLES_H
+#define INCLUDED_DRONEID_DECODER_TABLES_H
+
+#include <gnuradio/gr_complex.h>
+#include <array>
+#include <cstdint>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Constant tables of the burst decoder, built once per process. The
+ * integer ones at compile time, the ZC spectra on first use.
+ */
+
+// Coded bits of a burst, 6 data symbols of 600 QPSK subcarriers
+constexpr int CODED_BITS = 7200;
+constexpr int GOLDEN_WORDS = CODED_BITS / 32;
+
+// LTE Gold sequence, c_init from the DJI firmware. Same as
+// golden_sequence() in cpp/decoder.cpp, bit i is bit i % 32 of word i / 32.
+constexpr std::array<uint32_t, GOLDEN_WORDS> make_golden_words()
+{
+    constexpr int NC = 1600;
+    constexpr uint8_t X2_INIT[31] = { 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 1, 0, 1, 0,
+                                      0, 0, 1, 0, 1, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0 };
+    // Bit j of the registers is x(n + j)
+    uint32_t x1 = 1;
+    uint32_t x2 = 0;
+    for (int j = 0; j < 31; ++j) {
+        x2 |= uint32_t(X2_INIT[j]) << j;
+    }
+    std::array<uint32_t, GOLDEN_WORDS> words = {};
+    for (int n = 0; n < NC + CODED_BITS; ++n) {
+        if (n >= NC) {
+            words[(n - NC) / 32] |= ((x1 ^ x2) & 1) << ((n - NC) % 32);
+        }
+        const uint32_t b1 = (x1 ^ (x1 >> 3)) & 1;
+        const uint32_t b2 = (x2 ^ (x2 >> 1) ^ (x2 >> 2) ^ (x2 >> 3)) & 1;
+        x1 = (x1 >> 1) | (b1 << 30);
+        x2 = (x2 >> 1) | (b2 << 30);
+    }
+    return words;
+}
+
+inline constexpr std::array<uint32_t, GOLDEN_WORDS> GOLDEN_WORDS_TABLE = make_golden_words();
+
+constexpr bool golden_bit(int i) { return (GOLDEN_WORDS_TABLE[i / 32] >> (i % 32)) & 1; }
+
+// CRC24 0x864CFB, MSB first, the table in c/libdt.c
+constexpr std::array<uint32_t, 256> make_crc24_table()
+{
+    std::array<uint32_t, 256> t = {};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i << 16;
+        for (int b = 0; b < 8; ++b) {
+            c = (c & 0x800000) ? (c << 1) ^ 0x864CFB : c << 1;
+        }
+        t[i] = c & 0xFFFFFF;
+    }
+    return t;
+}
+
+inline constexpr std::array<uint32_t, 256> CRC24_TABLE = make_crc24_table();
+
+/*
+ * 1 / ZC on the 600 data subcarriers, the DC one left out, i.e. conj() as
+ * the sequence is unimodular. Aligned, read only, shared by all decoders.
+ * root is ZC_ROOT_SYMBOL_4 or ZC_ROOT_SYMBOL_6.
+ */
+const gr_complex* zc_reciprocal(int root);
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_DECODER_TABLES_H */
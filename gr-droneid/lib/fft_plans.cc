@@ -0,0 +1,218 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <gnuradio/droneid/fft_plans.h>
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/sys_paths.h>
+#include <fftw3.h>
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+namespace gr {
+namespace droneid {
+
+namespace {
+
+typedef std::tuple<int, int, int, int, bool> plan_key;
+
+// Everything below is guarded by gr::fft::planner::mutex()
+struct registry {
+    bool configured = false;
+    bool imported = false;
+    std::string wisdom_file;
+    fft_plans::effort_t effort = fft_plans::MEASURE;
+    std::map<plan_key, std::weak_ptr<const fft_plan>> plans;
+
+    static registry& get()
+    {
+        static registry r;
+        if (!r.configured) {
+            // A bad fftw_effort throws here, and again on the next call
+            prefs* p = prefs::singleton();
+            const fft_plans::effort_t effort = fft_plans::effort_from_string(
+                p->get_string("droneid", "fftw_effort", "measure"));
+            r.wisdom_file = p->get_string(
+                "droneid",
+                "fftw_wisdom",
+                std::string(gr::paths::userconf()) + "/droneid_fftw_wisdom");
+            r.effort = effort;
+            r.configured = true;
+        }
+        return r;
+    }
+
+    void import_wisdom()
+    {
+        if (!imported && !wisdom_file.empty()) {
+            // A missing file is the first start, not an error
+            fftwf_import_wisdom_from_filename(wisdom_file.c_str());
+        }
+        imported = true;
+    }
+
+    // Write next to the file and rename, a unit losing power mid export
+    // keeps the old wisdom
+    bool export_wisdom() const
+    {
+        if (wisdom_file.empty()) {
+            return false;
+        }
+        const std::string tmp = wisdom_file + ".tmp";
+        if (!fftwf_export_wisdom_to_filename(tmp.c_str())) {
+            return false;
+        }
+        return std::rename(tmp.c_str(), wisdom_file.c_str()) == 0;
+    }
+};
+
+unsigned int fftw_flags(fft_plans::effort_t effort)
+{
+    switch (effort) {
+    case fft_plans::ESTIMATE:
+        return FFTW_ESTIMATE;
+    case fft_plans::PATIENT:
+        return FFTW_PATIENT;
+    case fft_plans::WISDOM_ONLY:
+        return FFTW_WISDOM_ONLY;
+    default:
+        return FFTW_MEASURE;
+    }
+}
+
+} // namespace
+
+fft_plan::fft_plan(fftwf_plan p) : m_plan(p) {}
+
+fft_plan::~fft_plan()
+{
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    fftwf_destroy_plan(m_plan);
+}
+
+void fft_plan::execute(const gr_complex* in, gr_complex* out) const
+{
+    // fftwf_execute_dft() is the thread safe call, it doesn't write to in
+    // for an out of place complex plan
+    fftwf_execute_dft(m_plan,
+                      reinterpret_cast<fftwf_complex*>(const_cast<gr_complex*>(in)),
+                      reinterpret_cast<fftwf_complex*>(out));
+}
+
+void fft_plans::set_wisdom_file(const std::string& path)
+{
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    registry& r = registry::get();
+    r.wisdom_file = path;
+    r.imported = false;
+}
+
+std::string fft_plans::wisdom_file()
+{
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    return registry::get().wisdom_file;
+}
+
+void fft_plans::set_effort(effort_t effort)
+{
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    registry::get().effort = effort;
+}
+
+fft_plans::effort_t fft_plans::effort()
+{
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    return registry::get().effort;
+}
+
+fft_plans::effort_t fft_plans::effort_from_string(const std::string& name)
+{
+    if (name == "estimate") {
+        return ESTIMATE;
+    }
+    if (name == "measure") {
+        return MEASURE;
+    }
+    if (name == "patient") {
+        return PATIENT;
+    }
+    if (name == "wisdom_only") {
+        return WISDOM_ONLY;
+    }
+    throw std::invalid_argument("fft_plans: unknown effort " + name);
+}
+
+bool fft_plans::save_wisdom()
+{
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    return registry::get().export_wisdom();
+}
+
+std::shared_ptr<const fft_plan>
+fft_plans::get(int n, int howmany, int idist, int odist, bool forward)
+{
+    if (n < 1 || howmany < 1 || idist < n || odist < n) {
+        throw std::invalid_argument("fft_plans: bad plan geometry");
+    }
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    registry& r = registry::get();
+    const plan_key key(n, howmany, idist, odist, forward);
+    auto& slot = r.plans[key];
+    if (auto p = slot.lock()) {
+        return p;
+    }
+    r.import_wisdom();
+
+    // Measuring overwrites the arrays, plan on scratch ones. fftwf_malloc()
+    // gives the SIMD alignment the users' buffers have to match.
+    const size_t in_len = size_t(howmany - 1) * idist + n;
+    const size_t out_len = size_t(howmany - 1) * odist + n;
+    fftwf_complex* in = static_cast<fftwf_complex*>(fftwf_malloc(in_len * sizeof(fftwf_complex)));
+    fftwf_complex* out =
+        static_cast<fftwf_complex*>(fftwf_malloc(out_len * sizeof(fftwf_complex)));
+    fftwf_plan p = fftwf_plan_many_dft(1,
+                                       &n,
+                                       howmany,
+                                       in,
+                                       nullptr,
+                                       1,
+                                       idist,
+                                       out,
+                                       nullptr,
+                                       1,
+                                       odist,
+                                       forward ? FFTW_FORWARD : FFTW_BACKWARD,
+                                       fftw_flags(r.effort));
+    fftwf_free(in);
+    fftwf_free(out);
+    if (!p) {
+        throw std::runtime_error("fft_plans: can't plan " + std::to_string(n) +
+                                 " points, no wisdom in " + r.wisdom_file + "?");
+    }
+    if (r.effort == MEASURE || r.effort == PATIENT) {
+        r.export_wisdom();
+    }
+
+    std::shared_ptr<const fft_plan> sp = std::make_shared<const fft_plan>(p);
+    slot = sp;
+    return sp;
+}
+
+size_t fft_plans::size()
+{
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    size_t num = 0;
+    for (const auto& p : registry::get().plans) {
+        num += !p.second.expired();
+    }
+    return num;
+}
+
+} // namespace droneid
+} // namespace gr
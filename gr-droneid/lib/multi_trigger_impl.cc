@@ -0,0 +1,66 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "multi_trigger_impl.h"
+#include <gnuradio/io_signature.h>
+#include <stdexcept>
+
+namespace gr {
+namespace droneid {
+
+template <int N, int K>
+static multi_trigger::sptr make_multi(float fc,
+                                      float threshold,
+                                      int chunk_size,
+                                      int pre_trigger,
+                                      cfar_mode_t cfar_mode,
+                                      float cfar_threshold_db,
+                                      double samp_rate,
+                                      int holdoff,
+                                      int peak_window)
+{
+    return gnuradio::make_block_sptr<multi_trigger_impl<N, K>>("multi_trigger",
+                                                               fc,
+                                                               threshold,
+                                                               chunk_size,
+                                                               pre_trigger,
+                                                               cfar_mode,
+                                                               cfar_threshold_db,
+                                                               samp_rate,
+                                                               holdoff,
+                                                               peak_window);
+}
+
+multi_trigger::sptr multi_trigger::make(int num_inputs,
+                                        int k,
+                                        float fc,
+                                        float threshold,
+                                        int chunk_size,
+                                        int pre_trigger,
+                                        cfar_mode_t cfar_mode,
+                                        float cfar_threshold_db,
+                                        double samp_rate,
+                                        int holdoff,
+                                        int peak_window)
+{
+    typedef sptr (*make_t)(float, float, int, int, cfar_mode_t, float, double, int, int);
+    // One compiled kernel per (num_inputs, k), picked here once
+    static const make_t makers[4][4] = {
+        { make_multi<1, 1>, nullptr, nullptr, nullptr },
+        { make_multi<2, 1>, make_multi<2, 2>, nullptr, nullptr },
+        { make_multi<3, 1>, make_multi<3, 2>, make_multi<3, 3>, nullptr },
+        { make_multi<4, 1>, make_multi<4, 2>, make_multi<4, 3>, make_multi<4, 4> },
+    };
+    if (num_inputs < 1 || num_inputs > 4 || k < 1 || k > num_inputs) {
+        throw std::invalid_argument("multi_trigger: need 1 <= k <= num_inputs <= 4");
+    }
+    return makers[num_inputs - 1][k - 1](
+        fc, threshold, chunk_size, pre_trigger, cfar_mode, cfar_threshold_db, samp_rate, holdoff, peak_window);
+}
+
+} /* namespace droneid */
+} /* namespace gr */
@@ -0,0 +1,23 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_MULTI_TRIGGER_IMPL_H
+#define INCLUDED_DRONEID_MULTI_TRIGGER_IMPL_H
+
+#include <gnuradio/droneid/multi_trigger.h>
+#include "trigger_impl.h"
+
+namespace gr {
+namespace droneid {
+
+template <int N, int K>
+using multi_trigger_impl = trigger_impl<multi_trigger, N, K>;
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_MULTI_TRIGGER_IMPL_H */
@@ -0,0 +1,62 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "pdu_pool.h"
+#include <stdexcept>
+
+namespace gr {
+namespace droneid {
+
+pdu_pool::pdu_pool(size_t vector_len, size_t num_vectors, size_t max_vectors)
+    : m_len(vector_len), m_next(0), m_max(max_vectors)
+{
+    if (max_vectors < num_vectors) {
+        throw std::invalid_argument("pdu_pool: max_vectors is below num_vectors");
+    }
+    for (size_t i = 0; i < num_vectors; ++i) {
+        m_vectors.push_back(pmt::make_c32vector(m_len, gr_complex(0.f, 0.f)));
+    }
+}
+
+pmt::pmt_t pdu_pool::acquire(gr_complex*& data)
+{
+    // Round robin so a vector that was just released gets some time to cool off
+    const size_t n = m_vectors.size();
+    for (size_t i = 0; i < n; ++i) {
+        const size_t idx = (m_next + i) % n;
+        if (m_vectors[idx].use_count() == 1) {
+            m_next = (idx + 1) % n;
+            size_t len;
+            data = pmt::c32vector_writable_elements(m_vectors[idx], len);
+            return m_vectors[idx];
+        }
+    }
+    // Everything is still held downstream
+    if (n >= m_max) {
+        pmt::pmt_t v = pmt::make_c32vector(m_len, gr_complex(0.f, 0.f));
+        size_t len;
+        data = pmt::c32vector_writable_elements(v, len);
+        return v;
+    }
+    m_vectors.push_back(pmt::make_c32vector(m_len, gr_complex(0.f, 0.f)));
+    m_next = 0;
+    size_t len;
+    data = pmt::c32vector_writable_elements(m_vectors.back(), len);
+    return m_vectors.back();
+}
+
+size_t pdu_pool::in_flight() const
+{
+    size_t n = 0;
+    for (const auto& v : m_vectors) {
+        n += (v.use_count() > 1);
+    }
+    return n;
+}
+
+} // namespace droneid
+} // namespace gr
@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_PDU_POOL_H
+#define INCLUDED_DRONEID_PDU_POOL_H
+
+#include <pmt/pmt.h>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Pool of preallocated c32vectors for trigger PDUs.
+ *
+ * The pool keeps one reference to every vector. A vector is free again when
+ * that is the only reference left, i.e. when every subscriber that got the
+ * PDU has dropped it. Captures are written straight into the vector that is
+ * published, so there is no copy and no aliasing between bursts.
+ *
+ * The pool grows while every vector is in flight, up to max_vectors. Past
+ * that a slow consumer gets plain vectors the pool doesn't keep, so memory
+ * is freed with the PDUs instead of staying with the pool.
+ */
+class pdu_pool
+{
+private:
+    size_t m_len;
+    size_t m_next;
+    size_t m_max;
+    std::vector<pmt::pmt_t> m_vectors;
+
+public:
+    pdu_pool(size_t vector_len, size_t num_vectors, size_t max_vectors);
+
+    /*
+     * Return a vector nobody else holds and a pointer to its samples. The
+     * pool grows if all vectors are still in flight, above max_vectors the
+     * vector is allocated just for this call.
+     */
+    pmt::pmt_t acquire(gr_complex*& data);
+    size_t size() const { return m_vectors.size(); }
+    size_t in_flight() const;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_PDU_POOL_H */
@@ -0,0 +1,174 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "polyphase_resampler.h"
+#include <gnuradio/droneid/utilities.h>
+#include <gnuradio/filter/firdes.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace gr {
+namespace droneid {
+
+void reduce_ratio(int64_t& interpolation, int64_t& decimation)
+{
+    const int64_t g = std::gcd(interpolation, decimation);
+    if (g > 0) {
+        interpolation /= g;
+        decimation /= g;
+    }
+}
+
+std::vector<float> resampler_taps(int interpolation, int decimation, double samp_rate)
+{
+    const double out_rate = samp_rate * interpolation / decimation;
+    const double pass = DATA_CARRIERS / 2 * CARRIER_SPACING;
+    const double stop = std::min(samp_rate, out_rate) - pass;
+    if (stop <= pass) {
+        throw std::invalid_argument("resampler: rate too low for the DroneID channel");
+    }
+    return gr::filter::firdes::low_pass(interpolation,
+                                        interpolation * samp_rate,
+                                        .5 * (pass + stop),
+                                        stop - pass,
+                                        gr::fft::window::WIN_HAMMING);
+}
+
+polyphase_resampler::polyphase_resampler(int interpolation,
+                                         int decimation,
+                                         const std::vector<float>& taps,
+                                         double shift)
+{
+    if (interpolation < 1 || decimation < 1) {
+        throw std::invalid_argument("resampler: interpolation and decimation must be >= 1");
+    }
+    if (taps.empty()) {
+        throw std::invalid_argument("resampler: no taps");
+    }
+    int64_t l = interpolation;
+    int64_t m = decimation;
+    reduce_ratio(l, m);
+    m_interp = l;
+    m_decim = m;
+    m_ntaps = taps.size();
+    m_branch = (m_ntaps + m_interp - 1) / m_interp;
+    m_shift = shift;
+
+    // Branch p is taps p, p + L, p + 2L, ... the shift turns them complex
+    m_taps.resize(m_interp * m_branch);
+    const double w = 2. * M_PI * m_shift / m_interp;
+    for (int32_t p = 0; p < m_interp; ++p) {
+        for (int32_t i = 0; i < m_branch; ++i) {
+            const int32_t k = p + i * m_interp;
+            const gr_complex g = k < m_ntaps ? taps[k] * gr_complex(std::cos(w * k),
+                                                                     std::sin(w * k))
+                                             : gr_complex(0);
+            m_taps[p * m_branch + m_branch - 1 - i] = g;
+        }
+    }
+    const double wo = -2. * M_PI * m_shift * m_decim / m_interp;
+    m_rotator.set_phase_incr(gr_complex(std::cos(wo), std::sin(wo)));
+    m_pending.resize(m_branch);
+    reset();
+}
+
+void polyphase_resampler::reset()
+{
+    m_pos = 0;
+    set_phase(0);
+}
+
+void polyphase_resampler::set_phase(int64_t up)
+{
+    // Whole cycles taken out in double before the sin and cos
+    double cycles = m_shift * up / m_interp;
+    cycles -= std::floor(cycles);
+    const double w = -2. * M_PI * cycles;
+    m_rotator.set_phase(gr_complex(std::cos(w), std::sin(w)));
+}
+
+int polyphase_resampler::resample(
+    const gr_complex* in, int nin, gr_complex* out, int nout, int& consumed)
+{
+    // in + i0 is the window ending history() samples later, at new sample i0
+    int j = 0;
+    for (; j < nout; ++j) {
+        const int64_t i0 = m_pos / m_interp;
+        if (i0 >= nin) {
+            break;
+        }
+        const int32_t p = m_pos % m_interp;
+        volk_32fc_x2_dot_prod_32fc(out + j, in + i0, m_taps.data() + p * m_branch, m_branch);
+        m_pos += m_decim;
+    }
+    consumed = std::min<int64_t>(m_pos / m_interp, nin);
+    m_pos -= (int64_t)consumed * m_interp;
+    m_rotator.rotateN(out, out, j);
+    return j;
+}
+
+gr_complex polyphase_resampler::dot_clipped(const gr_complex* in,
+                                            int64_t last,
+                                            int32_t num,
+                                            int32_t p) const
+{
+    const gr_complex* taps = m_taps.data() + p * m_branch;
+    gr_complex acc = 0;
+    for (int32_t t = 0; t < m_branch; ++t) {
+        const int64_t n = last - m_branch + 1 + t;
+        if (n >= 0 && n < num) {
+            acc += taps[t] * in[n];
+        }
+    }
+    return acc;
+}
+
+int polyphase_resampler::burst_outputs(int num) const
+{
+    return ((int64_t)num * m_interp + m_decim - 1) / m_decim;
+}
+
+int polyphase_resampler::resample_burst(const gr_complex* in, int num, gr_complex* out)
+{
+    if (out == in && m_interp > m_decim) {
+        throw std::invalid_argument("resampler: in place only when decimating");
+    }
+    // Prototype delay at the up rate, output j is at input time jM / L
+    const int64_t delay = (m_ntaps - 1) / 2;
+    const int nout = burst_outputs(num);
+    set_phase(delay);
+
+    // Output j goes out once output j + branch - 1 is done, no later
+    // window reaches back to it when M >= L
+    const int32_t lag = m_branch - 1;
+    for (int j = 0; j < nout; ++j) {
+        const int64_t up = (int64_t)j * m_decim + delay;
+        const int64_t last = up / m_interp;
+        const int32_t p = up % m_interp;
+        gr_complex y;
+        if (last - m_branch + 1 >= 0 && last < num) {
+            volk_32fc_x2_dot_prod_32fc(
+                &y, in + last - m_branch + 1, m_taps.data() + p * m_branch, m_branch);
+        } else {
+            y = dot_clipped(in, last, num, p);
+        }
+        m_pending[j % m_branch] = m_rotator.rotate(y);
+        if (j >= lag) {
+            out[j - lag] = m_pending[(j - lag) % m_branch];
+        }
+    }
+    for (int j = std::max(nout - lag, 0); j < nout; ++j) {
+        out[j] = m_pending[j % m_branch];
+    }
+    return nout;
+}
+
+} // namespace droneid
+} // namespace gr
@@ -0,0 +1,102 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_POLYPHASE_RESAMPLER_H
+#define INCLUDED_DRONEID_POLYPHASE_RESAMPLER_H
+
+#include <gnuradio/blocks/rotator.h>
+#include <gnuradio/gr_complex.h>
+#include <volk/volk_alloc.hh>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Rational L / M polyphase resampler with a frequency shift.
+ *
+ * Output j is the prototype filter at L times the input rate evaluated at
+ * up rate sample jM, i.e. the dot product of branch jM mod L with the
+ * inputs ending at floor(jM / L). Only the branch taps are touched, one
+ * volk_32fc_x2_dot_prod_32fc() per output, and volk picks the AVX2 or
+ * NEON kernel.
+ *
+ * Shifting the input by -f before the filter is the same as filtering
+ * with h[k] exp(j 2pi f k / L) and rotating the output by
+ * exp(-j 2pi f jM / L), so the shift costs complex taps and a rotator at
+ * the output rate instead of a pass over the input.
+ */
+class polyphase_resampler
+{
+private:
+    int32_t m_interp;
+    int32_t m_decim;
+    int32_t m_ntaps;   // prototype length
+    int32_t m_branch;  // taps per branch
+    double m_shift;    // cycles per input sample
+    // Branch p at p * m_branch, reversed to line up with the input window
+    volk::vector<gr_complex> m_taps;
+    gr::blocks::rotator m_rotator;
+    // Up rate position of the next output, from the first new input sample
+    int64_t m_pos;
+    // Outputs held back by resample_burst() until their input is consumed
+    volk::vector<gr_complex> m_pending;
+
+    gr_complex dot_clipped(const gr_complex* in, int64_t last, int32_t num, int32_t p) const;
+    void set_phase(int64_t up);
+
+public:
+    /*
+     * taps is the low pass at interpolation times the input rate, with
+     * interpolation as its DC gain. shift is in cycles per input sample,
+     * the frequency that ends up at DC.
+     */
+    polyphase_resampler(int interpolation,
+                        int decimation,
+                        const std::vector<float>& taps,
+                        double shift);
+
+    int interpolation() const { return m_interp; }
+    int decimation() const { return m_decim; }
+    // Input samples of history before in[0] that resample() reads
+    int history() const { return m_branch - 1; }
+
+    /*
+     * Stream mode. in has history() old samples and then nin new ones.
+     * Writes up to nout outputs, returns how many, and how many of the
+     * new samples are done with in consumed.
+     */
+    int resample(const gr_complex* in, int nin, gr_complex* out, int nout, int& consumed);
+    void reset();
+
+    // Outputs resample_burst() writes for num inputs
+    int burst_outputs(int num) const;
+
+    /*
+     * Burst mode. The num samples at in, zero outside, to burst_outputs()
+     * samples at out with the filter delay removed, output j at input time
+     * jM / L like a zero phase filter. out may be in when decimating.
+     */
+    int resample_burst(const gr_complex* in, int num, gr_complex* out);
+};
+
+// The reduced L / M of two rates, or of an interpolation and decimation
+void reduce_ratio(int64_t& interpolation, int64_t& decimation);
+
+/*
+ * Low pass for the DroneID channel at interpolation times samp_rate: flat
+ * over the 9 MHz of subcarriers and stopping where either the input or
+ * the output rate would fold anything back on them.
+ */
+std::vector<float>
+resampler_taps(int interpolation, int decimation, double samp_rate);
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_POLYPHASE_RESAMPLER_H */
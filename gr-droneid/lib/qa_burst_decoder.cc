@@ -0,0 +1,178 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "burst_decoder.h"
+#include "decoder_tables.h"
+#include <gnuradio/droneid/utilities.h>
+#include <gnuradio/fft/fft.h>
+#include <boost/test/unit_test.hpp>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+/*
+ * Every heap allocation of the process is counted while s_counting is set.
+ * With glibc the malloc family is interposed, which also sees operator new
+ * and the volk and FFTW allocators, elsewhere operator new is replaced.
+ */
+static bool s_counting = false;
+static long s_allocs = 0;
+
+static void count_alloc()
+{
+    if (s_counting) {
+        s_allocs++;
+    }
+}
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size)
+{
+    count_alloc();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size)
+{
+    count_alloc();
+    return __libc_calloc(num, size);
+}
+
+void* realloc(void* p, size_t size)
+{
+    count_alloc();
+    return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    count_alloc();
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    count_alloc();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** p, size_t alignment, size_t size)
+{
+    count_alloc();
+    *p = __libc_memalign(alignment, size);
+    return *p ? 0 : ENOMEM;
+}
+}
+#else
+void* operator new(size_t size)
+{
+    count_alloc();
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+#endif
+
+namespace {
+
+using namespace gr::droneid;
+
+/*
+ * A burst at samp_rate with noise around it. The ZC symbols are the real
+ * ones, the data random QPSK, so it is found and fully decoded but fails
+ * the CRC. zc4 is set to its first ZC symbol.
+ */
+std::vector<gr_complex> make_capture(double samp_rate, int32_t& zc4)
+{
+    const int n = fft_size(samp_rate);
+    const int pre = 2 * n;
+    std::vector<gr_complex> x(pre + burst_length(samp_rate) + 2 * n);
+
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.f, 0.01f);
+    for (auto& s : x) {
+        s = gr_complex(noise(rng), noise(rng));
+    }
+
+    const gr_complex* zc[2] = { zc_reciprocal(ZC_ROOT_SYMBOL_4),
+                                zc_reciprocal(ZC_ROOT_SYMBOL_6) };
+    gr::fft::fft_complex_rev ifft(n);
+    gr_complex* f = ifft.get_inbuf();
+    const float scale = 1.f / std::sqrt((float)n);
+    int pos = pre;
+    for (int s = 0; s < NUM_SYMBOLS; ++s) {
+        std::fill(f, f + n, gr_complex(0.f, 0.f));
+        for (int k = 0; k < DATA_CARRIERS; ++k) {
+            // Negative frequencies first, DC left out
+            const int bin = k < DATA_CARRIERS / 2 ? n - DATA_CARRIERS / 2 + k
+                                                  : k - DATA_CARRIERS / 2 + 1;
+            if (s == 2 || s == 4) {
+                f[bin] = std::conj(zc[s / 2 - 1][k]);
+            } else {
+                f[bin] = gr_complex(rng() & 1 ? -1.f : 1.f, rng() & 1 ? -1.f : 1.f) *
+                         (float)M_SQRT1_2;
+            }
+        }
+        ifft.execute();
+        const gr_complex* t = ifft.get_outbuf();
+        const int cp = s == NUM_SYMBOLS - 1 ? long_cp(samp_rate) : short_cp(samp_rate);
+        for (int j = 0; j < cp; ++j) {
+            x[pos + j] += t[n - cp + j] * scale;
+        }
+        for (int j = 0; j < n; ++j) {
+            x[pos + cp + j] += t[j] * scale;
+        }
+        pos += cp + n;
+    }
+    zc4 = pre + zc4_offset(samp_rate);
+    return x;
+}
+
+void check_no_allocations(double samp_rate)
+{
+    int32_t zc4;
+    const std::vector<gr_complex> x = make_capture(samp_rate, zc4);
+    auto decoder = burst_decoder::make(samp_rate);
+    decode_result r;
+    BOOST_REQUIRE(decoder->decode(x.data(), x.size(), zc4, r));
+
+    s_allocs = 0;
+    s_counting = true;
+    bool found = true;
+    for (int i = 0; i < 4; ++i) {
+        found &= decoder->decode(x.data(), x.size(), zc4, r);
+    }
+    s_counting = false;
+    BOOST_CHECK(found);
+    BOOST_CHECK_EQUAL(s_allocs, 0);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_decode_1024_no_allocations) { check_no_allocations(15.36e6); }
+
+BOOST_AUTO_TEST_CASE(t_decode_2048_no_allocations) { check_no_allocations(30.72e6); }
+
+BOOST_AUTO_TEST_CASE(t_decode_4096_no_allocations) { check_no_allocations(61.44e6); }
+
+BOOST_AUTO_TEST_CASE(t_decode_resampled_no_allocations) { check_no_allocations(50e6); }
@@ -0,0 +1,157 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qpsk_demap.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DRONEID_DEMAP_X86
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define DRONEID_DEMAP_NEON
+#include <arm_neon.h>
+#endif
+
+namespace gr {
+namespace droneid {
+
+static constexpr float LLR_MAX = 63.f;
+
+static void qpsk_demap_generic(const gr_complex* y,
+                               const gr_complex* w,
+                               const float* sign,
+                               float scale,
+                               int8_t* llr,
+                               int num)
+{
+    for (int k = 0; k < num; ++k) {
+        const gr_complex v = y[k] * w[k];
+        const float re = v.real() * (sign[2 * k] * scale);
+        const float im = v.imag() * (sign[2 * k + 1] * scale);
+        llr[2 * k] = std::nearbyint(std::min(std::max(re, -LLR_MAX), LLR_MAX));
+        llr[2 * k + 1] = std::nearbyint(std::min(std::max(im, -LLR_MAX), LLR_MAX));
+    }
+}
+
+#ifdef DRONEID_DEMAP_X86
+
+// 4 interleaved complex products, y * w
+__attribute__((target("avx2"))) static inline __m256 cmul_avx2(__m256 a, __m256 b)
+{
+    const __m256 br = _mm256_moveldup_ps(b);
+    const __m256 bi = _mm256_movehdup_ps(b);
+    const __m256 swap = _mm256_permute_ps(a, 0xb1);
+    return _mm256_addsub_ps(_mm256_mul_ps(a, br), _mm256_mul_ps(swap, bi));
+}
+
+__attribute__((target("avx2"))) static void qpsk_demap_avx2(const gr_complex* y,
+                                                            const gr_complex* w,
+                                                            const float* sign,
+                                                            float scale,
+                                                            int8_t* llr,
+                                                            int num)
+{
+    const float* fy = reinterpret_cast<const float*>(y);
+    const float* fw = reinterpret_cast<const float*>(w);
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 hi = _mm256_set1_ps(LLR_MAX);
+    const __m256 lo = _mm256_set1_ps(-LLR_MAX);
+    // 8 subcarriers, 16 LLRs per iteration. I and Q stay interleaved from
+    // the complex product to the output
+    int k = 0;
+    for (; k + 16 <= 2 * num; k += 16) {
+        __m256 v0 = cmul_avx2(_mm256_loadu_ps(fy + k), _mm256_loadu_ps(fw + k));
+        __m256 v1 = cmul_avx2(_mm256_loadu_ps(fy + k + 8), _mm256_loadu_ps(fw + k + 8));
+        v0 = _mm256_mul_ps(v0, _mm256_mul_ps(_mm256_loadu_ps(sign + k), s));
+        v1 = _mm256_mul_ps(v1, _mm256_mul_ps(_mm256_loadu_ps(sign + k + 8), s));
+        v0 = _mm256_min_ps(_mm256_max_ps(v0, lo), hi);
+        v1 = _mm256_min_ps(_mm256_max_ps(v1, lo), hi);
+        // packs works per 128 bit lane, the permute puts the 16 bit values
+        // back in order before the last pack
+        __m256i p = _mm256_packs_epi32(_mm256_cvtps_epi32(v0), _mm256_cvtps_epi32(v1));
+        p = _mm256_permute4x64_epi64(p, 0xd8);
+        const __m128i b =
+            _mm_packs_epi16(_mm256_castsi256_si128(p), _mm256_extracti128_si256(p, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(llr + k), b);
+    }
+    qpsk_demap_generic(y + k / 2, w + k / 2, sign + k, scale, llr + k, num - k / 2);
+}
+
+#endif /* DRONEID_DEMAP_X86 */
+
+#ifdef DRONEID_DEMAP_NEON
+
+static void qpsk_demap_neon(const gr_complex* y,
+                            const gr_complex* w,
+                            const float* sign,
+                            float scale,
+                            int8_t* llr,
+                            int num)
+{
+    const float* fy = reinterpret_cast<const float*>(y);
+    const float* fw = reinterpret_cast<const float*>(w);
+    const float32x4_t hi = vdupq_n_f32(LLR_MAX);
+    const float32x4_t lo = vdupq_n_f32(-LLR_MAX);
+    // 8 subcarriers, 16 LLRs per iteration, I and Q deinterleaved on load
+    // and interleaved again on the store
+    int k = 0;
+    for (; k + 16 <= 2 * num; k += 16) {
+        int16x4_t re16[2];
+        int16x4_t im16[2];
+        for (int h = 0; h < 2; ++h) {
+            const float32x4x2_t a = vld2q_f32(fy + k + 8 * h);
+            const float32x4x2_t b = vld2q_f32(fw + k + 8 * h);
+            const float32x4x2_t g = vld2q_f32(sign + k + 8 * h);
+            float32x4_t re = vmlsq_f32(vmulq_f32(a.val[0], b.val[0]), a.val[1], b.val[1]);
+            float32x4_t im = vmlaq_f32(vmulq_f32(a.val[0], b.val[1]), a.val[1], b.val[0]);
+            re = vmulq_f32(re, vmulq_n_f32(g.val[0], scale));
+            im = vmulq_f32(im, vmulq_n_f32(g.val[1], scale));
+            re = vminq_f32(vmaxq_f32(re, lo), hi);
+            im = vminq_f32(vmaxq_f32(im, lo), hi);
+            re16[h] = vqmovn_s32(vcvtnq_s32_f32(re));
+            im16[h] = vqmovn_s32(vcvtnq_s32_f32(im));
+        }
+        int8x8x2_t out;
+        out.val[0] = vqmovn_s16(vcombine_s16(re16[0], re16[1]));
+        out.val[1] = vqmovn_s16(vcombine_s16(im16[0], im16[1]));
+        vst2_s8(llr + k, out);
+    }
+    qpsk_demap_generic(y + k / 2, w + k / 2, sign + k, scale, llr + k, num - k / 2);
+}
+
+#endif /* DRONEID_DEMAP_NEON */
+
+std::vector<qpsk_demap_arch> qpsk_demap_archs()
+{
+    std::vector<qpsk_demap_arch> archs;
+    archs.push_back({ "generic", qpsk_demap_generic });
+#ifdef DRONEID_DEMAP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        archs.push_back({ "avx2", qpsk_demap_avx2 });
+    }
+#endif
+#ifdef DRONEID_DEMAP_NEON
+    archs.push_back({ "neon", qpsk_demap_neon });
+#endif
+    return archs;
+}
+
+void qpsk_demap(const gr_complex* y,
+                const gr_complex* w,
+                const float* sign,
+                float scale,
+                int8_t* llr,
+                int num)
+{
+    static const qpsk_demap_arch arch = qpsk_demap_archs().back();
+    arch.demap(y, w, sign, scale, llr, num);
+}
+
+} // namespace droneid
+} // namespace gr
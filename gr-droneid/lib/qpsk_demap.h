@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_QPSK_DEMAP_H
+#define INCLUDED_DRONEID_QPSK_DEMAP_H
+
+#include <gnuradio/gr_complex.h>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Equalize and demap num QPSK subcarriers to 2 * num int8 LLRs.
+ *
+ * llr[2k] and llr[2k + 1] are I and Q of y[k] * w[k] times sign[2k] and
+ * sign[2k + 1] and scale, rounded and saturated to +-63. The sign table
+ * takes the descrambling, -1 where the scrambling bit is 0 and +1 where it
+ * is 1 gives the turbo decoder's convention of a one being positive. With
+ * w the reciprocal channel and a scale of FLT_MAX it is a hard slicer, with
+ * w = conj(h) / noise (times the int8 scaling) it writes soft LLRs.
+ *
+ * No branches in the vector loop, 8 subcarriers at a time and the rest in
+ * the generic code. The subcarrier order is the caller's, the decoder
+ * passes runs of FFT bins. Dispatched on first use like find_first_above().
+ */
+void qpsk_demap(const gr_complex* y,
+                const gr_complex* w,
+                const float* sign,
+                float scale,
+                int8_t* llr,
+                int num);
+
+typedef void (*qpsk_demap_t)(
+    const gr_complex*, const gr_complex*, const float*, float, int8_t*, int);
+
+struct qpsk_demap_arch {
+    const char* name;
+    qpsk_demap_t demap;
+};
+
+/*
+ * All implementations the running CPU supports, generic first and the
+ * dispatched one last.
+ */
+std::vector<qpsk_demap_arch> qpsk_demap_archs();
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_QPSK_DEMAP_H */
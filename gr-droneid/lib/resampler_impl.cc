@@ -0,0 +1,104 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "resampler_impl.h"
+#include <gnuradio/io_signature.h>
+
+namespace gr {
+namespace droneid {
+
+resampler::sptr resampler::make(double samp_rate,
+                                int interpolation,
+                                int decimation,
+                                double shift_freq,
+                                const std::vector<float>& taps)
+{
+    return gnuradio::make_block_sptr<resampler_impl>(
+        samp_rate, interpolation, decimation, shift_freq, taps);
+}
+
+static std::vector<float>
+prototype(double samp_rate, int interpolation, int decimation, const std::vector<float>& taps)
+{
+    if (!taps.empty()) {
+        return taps;
+    }
+    int64_t l = interpolation;
+    int64_t m = decimation;
+    reduce_ratio(l, m);
+    return resampler_taps(l, m, samp_rate);
+}
+
+resampler_impl::resampler_impl(double samp_rate,
+                               int interpolation,
+                               int decimation,
+                               double shift_freq,
+                               const std::vector<float>& taps)
+    : gr::block("resampler",
+                gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                gr::io_signature::make(1, 1, sizeof(gr_complex))),
+      m_samp_rate(samp_rate),
+      m_shift_freq(shift_freq),
+      m_resampler(interpolation,
+                  decimation,
+                  prototype(samp_rate, interpolation, decimation, taps),
+                  shift_freq / samp_rate)
+{
+    set_history(m_resampler.history() + 1);
+    set_relative_rate((uint64_t)m_resampler.interpolation(),
+                      (uint64_t)m_resampler.decimation());
+    // Tags are passed on in general_work(), rx_rate and fc change
+    set_tag_propagation_policy(TPP_DONT);
+}
+
+resampler_impl::~resampler_impl() {}
+
+double resampler_impl::out_rate() const
+{
+    return m_samp_rate * m_resampler.interpolation() / m_resampler.decimation();
+}
+
+void resampler_impl::forecast(int noutput_items, gr_vector_int& ninput_items_required)
+{
+    ninput_items_required[0] =
+        (int64_t)noutput_items * m_resampler.decimation() / m_resampler.interpolation() + 1;
+}
+
+void resampler_impl::propagate_tags(int consumed)
+{
+    get_tags_in_range(m_tags, 0, nitems_read(0), nitems_read(0) + consumed);
+    const int64_t l = m_resampler.interpolation();
+    const int64_t m = m_resampler.decimation();
+    for (const auto& tag : m_tags) {
+        pmt::pmt_t value = tag.value;
+        if (pmt::eq(tag.key, pmt::mp("rx_rate"))) {
+            value = pmt::from_double(pmt::to_double(value) * l / m);
+        } else if (pmt::eq(tag.key, pmt::mp("fc"))) {
+            value = pmt::mp(pmt::to_double(value) + m_shift_freq * 1.e-6);
+        }
+        add_item_tag(0, tag.offset * l / m, tag.key, value, tag.srcid);
+    }
+}
+
+int resampler_impl::general_work(int noutput_items,
+                                 gr_vector_int& ninput_items,
+                                 gr_vector_const_void_star& input_items,
+                                 gr_vector_void_star& output_items)
+{
+    auto in = static_cast<const gr_complex*>(input_items[0]);
+    auto out = static_cast<gr_complex*>(output_items[0]);
+
+    int consumed;
+    const int produced =
+        m_resampler.resample(in, ninput_items[0], out, noutput_items, consumed);
+    propagate_tags(consumed);
+    consume_each(consumed);
+    return produced;
+}
+
+} /* namespace droneid */
+} /* namespace gr */
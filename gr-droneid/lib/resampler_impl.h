@@ -0,0 +1,45 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_RESAMPLER_IMPL_H
+#define INCLUDED_DRONEID_RESAMPLER_IMPL_H
+
+#include "polyphase_resampler.h"
+#include <gnuradio/droneid/resampler.h>
+
+namespace gr {
+namespace droneid {
+
+class resampler_impl : public resampler
+{
+private:
+    const double m_samp_rate;
+    const double m_shift_freq;
+    polyphase_resampler m_resampler;
+    std::vector<tag_t> m_tags;
+
+    void propagate_tags(int consumed);
+
+public:
+    resampler_impl(double samp_rate,
+                   int interpolation,
+                   int decimation,
+                   double shift_freq,
+                   const std::vector<float>& taps);
+    ~resampler_impl();
+    double out_rate() const override;
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_RESAMPLER_IMPL_H */
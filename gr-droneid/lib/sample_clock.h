@@ -0,0 +1,58 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_SAMPLE_CLOCK_H
+#define INCLUDED_DRONEID_SAMPLE_CLOCK_H
+
+#include <gnuradio/tags.h>
+#include <cstdint>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Absolute time of a sample item from rx_time / rx_rate stream tags.
+ *
+ * The clock keeps one reference, the item of the last rx_time tag with its
+ * whole and fractional seconds, and the sample rate. A time is the reference
+ * plus an integer item delta divided by the rate, split in whole seconds and
+ * a remainder with one fma, so nothing is accumulated and a run of days is
+ * as accurate as the first second. A rate change without a new rx_time
+ * moves the reference to the tag item first.
+ */
+class sample_clock
+{
+private:
+    bool m_valid;
+    uint64_t m_ref_item;
+    uint64_t m_ref_secs;
+    double m_ref_frac;
+    double m_rate;
+
+public:
+    explicit sample_clock(double rate);
+
+    // Apply t if it is an rx_time or rx_rate tag. Tags go in in order().
+    bool apply(const tag_t& t);
+    // By item, and on the same item a rate before a time, so the time isn't
+    // rebased with the old rate
+    static bool order(const tag_t& a, const tag_t& b);
+    // Item 0 is at secs + frac, until an rx_time tag says otherwise
+    void set_epoch(uint64_t secs, double frac);
+    void set_rate(uint64_t item, double rate);
+    void set_time(uint64_t item, uint64_t secs, double frac);
+    // False before the first rx_time tag or epoch
+    bool valid() const { return m_valid; }
+    double rate() const { return m_rate; }
+    // Time of item + item_frac, frac in [0, 1)
+    void time_at(uint64_t item, double item_frac, uint64_t& secs, double& frac) const;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_SAMPLE_CLOCK_H */
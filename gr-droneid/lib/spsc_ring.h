@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_SPSC_RING_H
+#define INCLUDED_DRONEID_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Bounded single producer, single consumer ring, ringbuffer2 in
+ * cpp/ringbuffer.cpp. Each side caches the other's index and only reads
+ * the shared one when the cached one says full or empty. Holds
+ * capacity - 1 items.
+ *
+ * pop() moves the item out, so a popped pmt doesn't keep its vector out of
+ * the PDU pool while it sits in the ring.
+ */
+template <typename T>
+class spsc_ring
+{
+private:
+    std::vector<T> m_data;
+    alignas(64) std::atomic<size_t> m_read{ 0 };
+    alignas(64) size_t m_write_cached = 0;
+    alignas(64) std::atomic<size_t> m_write{ 0 };
+    alignas(64) size_t m_read_cached = 0;
+
+public:
+    explicit spsc_ring(size_t capacity) : m_data(capacity + 1) {}
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    // Producer, false if full
+    bool push(T&& val)
+    {
+        const size_t w = m_write.load(std::memory_order_relaxed);
+        size_t next = w + 1;
+        if (next == m_data.size()) {
+            next = 0;
+        }
+        if (next == m_read_cached) {
+            m_read_cached = m_read.load(std::memory_order_acquire);
+            if (next == m_read_cached) {
+                return false;
+            }
+        }
+        m_data[w] = std::move(val);
+        m_write.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer, false if empty
+    bool pop(T& val)
+    {
+        const size_t r = m_read.load(std::memory_order_relaxed);
+        if (r == m_write_cached) {
+            m_write_cached = m_write.load(std::memory_order_acquire);
+            if (r == m_write_cached) {
+                return false;
+            }
+        }
+        val = std::move(m_data[r]);
+        size_t next = r + 1;
+        if (next == m_data.size()) {
+            next = 0;
+        }
+        m_read.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Either side or a third thread, a snapshot
+    size_t size() const
+    {
+        const size_t w = m_write.load(std::memory_order_acquire);
+        const size_t r = m_read.load(std::memory_order_acquire);
+        return w >= r ? w - r : w + m_data.size() - r;
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return m_data.size() - 1; }
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_SPSC_RING_H */
@@ -0,0 +1,411 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "threshold_scan.h"
+#include <cstdint>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DRONEID_SCAN_X86
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define DRONEID_SCAN_NEON
+#include <arm_neon.h>
+#endif
+
+namespace gr {
+namespace droneid {
+
+static int find_first_above_generic(const float* x, int num, float thr)
+{
+    for (int i = 0; i < num; ++i) {
+        if (x[i] > thr) {
+            return i;
+        }
+    }
+    return num;
+}
+
+static int find_first_above_both_generic(const float* x, const float* y, int num, float thr_x, float thr_y)
+{
+    for (int i = 0; i < num; ++i) {
+        if ((x[i] > thr_x) & (y[i] > thr_y)) {
+            return i;
+        }
+    }
+    return num;
+}
+
+// Number of streams above threshold at sample i
+template <size_t... J>
+static inline int count_above(const float* const* x, const float* thr, int i, std::index_sequence<J...>)
+{
+    return ((x[J][i] > thr[J]) + ...);
+}
+
+template <int N, int K>
+static int find_first_k_above_generic(const float* const* x, const float* thr, int first, int num)
+{
+    for (int i = first; i < num; ++i) {
+        if (count_above(x, thr, i, std::make_index_sequence<N>()) >= K) {
+            return i;
+        }
+    }
+    return num;
+}
+
+#ifdef DRONEID_SCAN_X86
+
+__attribute__((target("avx2"))) static int
+find_first_above_avx2(const float* x, int num, float thr)
+{
+    const __m256 t = _mm256_set1_ps(thr);
+    int i = 0;
+    // 32 samples per iteration, one branch
+    for (; i + 32 <= num; i += 32) {
+        const __m256 m0 = _mm256_cmp_ps(_mm256_loadu_ps(x + i), t, _CMP_GT_OQ);
+        const __m256 m1 = _mm256_cmp_ps(_mm256_loadu_ps(x + i + 8), t, _CMP_GT_OQ);
+        const __m256 m2 = _mm256_cmp_ps(_mm256_loadu_ps(x + i + 16), t, _CMP_GT_OQ);
+        const __m256 m3 = _mm256_cmp_ps(_mm256_loadu_ps(x + i + 24), t, _CMP_GT_OQ);
+        const __m256 any = _mm256_or_ps(_mm256_or_ps(m0, m1), _mm256_or_ps(m2, m3));
+        if (!_mm256_testz_ps(any, any)) {
+            const uint32_t bits = (uint32_t)_mm256_movemask_ps(m0) |
+                                  ((uint32_t)_mm256_movemask_ps(m1) << 8) |
+                                  ((uint32_t)_mm256_movemask_ps(m2) << 16) |
+                                  ((uint32_t)_mm256_movemask_ps(m3) << 24);
+            return i + __builtin_ctz(bits);
+        }
+    }
+    for (; i + 8 <= num; i += 8) {
+        const int bits = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(x + i), t, _CMP_GT_OQ));
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i + find_first_above_generic(x + i, num - i, thr);
+}
+
+__attribute__((target("avx2"))) static int
+find_first_above_both_avx2(const float* x, const float* y, int num, float thr_x, float thr_y)
+{
+    const __m256 tx = _mm256_set1_ps(thr_x);
+    const __m256 ty = _mm256_set1_ps(thr_y);
+    int i = 0;
+    for (; i + 16 <= num; i += 16) {
+        const __m256 m0 = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(x + i), tx, _CMP_GT_OQ),
+                                        _mm256_cmp_ps(_mm256_loadu_ps(y + i), ty, _CMP_GT_OQ));
+        const __m256 m1 = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(x + i + 8), tx, _CMP_GT_OQ),
+                                        _mm256_cmp_ps(_mm256_loadu_ps(y + i + 8), ty, _CMP_GT_OQ));
+        const __m256 any = _mm256_or_ps(m0, m1);
+        if (!_mm256_testz_ps(any, any)) {
+            const uint32_t bits = (uint32_t)_mm256_movemask_ps(m0) |
+                                  ((uint32_t)_mm256_movemask_ps(m1) << 8);
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i + find_first_above_both_generic(x + i, y + i, num - i, thr_x, thr_y);
+}
+
+__attribute__((target("avx512f"))) static int
+find_first_above_avx512(const float* x, int num, float thr)
+{
+    const __m512 t = _mm512_set1_ps(thr);
+    int i = 0;
+    for (; i + 64 <= num; i += 64) {
+        const uint64_t bits =
+            (uint64_t)_mm512_cmp_ps_mask(_mm512_loadu_ps(x + i), t, _CMP_GT_OQ) |
+            ((uint64_t)_mm512_cmp_ps_mask(_mm512_loadu_ps(x + i + 16), t, _CMP_GT_OQ) << 16) |
+            ((uint64_t)_mm512_cmp_ps_mask(_mm512_loadu_ps(x + i + 32), t, _CMP_GT_OQ) << 32) |
+            ((uint64_t)_mm512_cmp_ps_mask(_mm512_loadu_ps(x + i + 48), t, _CMP_GT_OQ) << 48);
+        if (bits) {
+            return i + __builtin_ctzll(bits);
+        }
+    }
+    for (; i + 16 <= num; i += 16) {
+        const uint32_t bits = _mm512_cmp_ps_mask(_mm512_loadu_ps(x + i), t, _CMP_GT_OQ);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i + find_first_above_generic(x + i, num - i, thr);
+}
+
+__attribute__((target("avx512f"))) static int
+find_first_above_both_avx512(const float* x, const float* y, int num, float thr_x, float thr_y)
+{
+    const __m512 tx = _mm512_set1_ps(thr_x);
+    const __m512 ty = _mm512_set1_ps(thr_y);
+    int i = 0;
+    for (; i + 32 <= num; i += 32) {
+        // The AND happens in the mask registers
+        const __mmask16 m0 = _mm512_mask_cmp_ps_mask(
+            _mm512_cmp_ps_mask(_mm512_loadu_ps(x + i), tx, _CMP_GT_OQ),
+            _mm512_loadu_ps(y + i),
+            ty,
+            _CMP_GT_OQ);
+        const __mmask16 m1 = _mm512_mask_cmp_ps_mask(
+            _mm512_cmp_ps_mask(_mm512_loadu_ps(x + i + 16), tx, _CMP_GT_OQ),
+            _mm512_loadu_ps(y + i + 16),
+            ty,
+            _CMP_GT_OQ);
+        const uint32_t bits = (uint32_t)m0 | ((uint32_t)m1 << 16);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i + find_first_above_both_generic(x + i, y + i, num - i, thr_x, thr_y);
+}
+
+template <int K, size_t... J>
+__attribute__((target("avx2"))) static inline __m256
+k_above_avx2(const float* const* x, const __m256* t, int i, std::index_sequence<J...>)
+{
+    constexpr int n = sizeof...(J);
+    if constexpr (K == n) {
+        __m256 m = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        ((m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(x[J] + i), t[J], _CMP_GT_OQ))), ...);
+        return m;
+    } else if constexpr (K == 1) {
+        __m256 m = _mm256_setzero_ps();
+        ((m = _mm256_or_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(x[J] + i), t[J], _CMP_GT_OQ))), ...);
+        return m;
+    } else {
+        // The masks are -1 per stream above, subtracting them counts
+        __m256i c = _mm256_setzero_si256();
+        ((c = _mm256_sub_epi32(
+              c, _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(x[J] + i), t[J], _CMP_GT_OQ)))),
+         ...);
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(c, _mm256_set1_epi32(K - 1)));
+    }
+}
+
+template <int N, int K>
+__attribute__((target("avx2"))) static int
+find_first_k_above_avx2(const float* const* x, const float* thr, int num)
+{
+    __m256 t[N];
+    for (int j = 0; j < N; ++j) {
+        t[j] = _mm256_set1_ps(thr[j]);
+    }
+    int i = 0;
+    for (; i + 16 <= num; i += 16) {
+        const __m256 m0 = k_above_avx2<K>(x, t, i, std::make_index_sequence<N>());
+        const __m256 m1 = k_above_avx2<K>(x, t, i + 8, std::make_index_sequence<N>());
+        const __m256 any = _mm256_or_ps(m0, m1);
+        if (!_mm256_testz_ps(any, any)) {
+            const uint32_t bits = (uint32_t)_mm256_movemask_ps(m0) |
+                                  ((uint32_t)_mm256_movemask_ps(m1) << 8);
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return find_first_k_above_generic<N, K>(x, thr, i, num);
+}
+
+template <int K, size_t... J>
+__attribute__((target("avx512f"))) static inline __mmask16
+k_above_avx512(const float* const* x, const __m512* t, int i, std::index_sequence<J...>)
+{
+    constexpr int n = sizeof...(J);
+    if constexpr (K == n) {
+        // The AND happens in the mask registers
+        __mmask16 m = 0xffff;
+        ((m = _mm512_mask_cmp_ps_mask(m, _mm512_loadu_ps(x[J] + i), t[J], _CMP_GT_OQ)), ...);
+        return m;
+    } else if constexpr (K == 1) {
+        __mmask16 m = 0;
+        ((m |= _mm512_cmp_ps_mask(_mm512_loadu_ps(x[J] + i), t[J], _CMP_GT_OQ)), ...);
+        return m;
+    } else {
+        const __m512i one = _mm512_set1_epi32(1);
+        __m512i c = _mm512_setzero_si512();
+        ((c = _mm512_mask_add_epi32(
+              c, _mm512_cmp_ps_mask(_mm512_loadu_ps(x[J] + i), t[J], _CMP_GT_OQ), c, one)),
+         ...);
+        return _mm512_cmpgt_epi32_mask(c, _mm512_set1_epi32(K - 1));
+    }
+}
+
+template <int N, int K>
+__attribute__((target("avx512f"))) static int
+find_first_k_above_avx512(const float* const* x, const float* thr, int num)
+{
+    __m512 t[N];
+    for (int j = 0; j < N; ++j) {
+        t[j] = _mm512_set1_ps(thr[j]);
+    }
+    int i = 0;
+    for (; i + 32 <= num; i += 32) {
+        const uint32_t bits =
+            (uint32_t)k_above_avx512<K>(x, t, i, std::make_index_sequence<N>()) |
+            ((uint32_t)k_above_avx512<K>(x, t, i + 16, std::make_index_sequence<N>()) << 16);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return find_first_k_above_generic<N, K>(x, thr, i, num);
+}
+
+#endif /* DRONEID_SCAN_X86 */
+
+#ifdef DRONEID_SCAN_NEON
+
+static int find_first_above_neon(const float* x, int num, float thr)
+{
+    const float32x4_t t = vdupq_n_f32(thr);
+    int i = 0;
+    for (; i + 16 <= num; i += 16) {
+        const uint32x4_t m0 = vcgtq_f32(vld1q_f32(x + i), t);
+        const uint32x4_t m1 = vcgtq_f32(vld1q_f32(x + i + 4), t);
+        const uint32x4_t m2 = vcgtq_f32(vld1q_f32(x + i + 8), t);
+        const uint32x4_t m3 = vcgtq_f32(vld1q_f32(x + i + 12), t);
+        const uint32x4_t any = vorrq_u32(vorrq_u32(m0, m1), vorrq_u32(m2, m3));
+        if (vmaxvq_u32(any)) {
+            return i + find_first_above_generic(x + i, 16, thr);
+        }
+    }
+    return i + find_first_above_generic(x + i, num - i, thr);
+}
+
+static int find_first_above_both_neon(const float* x, const float* y, int num, float thr_x, float thr_y)
+{
+    const float32x4_t tx = vdupq_n_f32(thr_x);
+    const float32x4_t ty = vdupq_n_f32(thr_y);
+    int i = 0;
+    for (; i + 8 <= num; i += 8) {
+        const uint32x4_t m0 =
+            vandq_u32(vcgtq_f32(vld1q_f32(x + i), tx), vcgtq_f32(vld1q_f32(y + i), ty));
+        const uint32x4_t m1 = vandq_u32(vcgtq_f32(vld1q_f32(x + i + 4), tx),
+                                        vcgtq_f32(vld1q_f32(y + i + 4), ty));
+        if (vmaxvq_u32(vorrq_u32(m0, m1))) {
+            return i + find_first_above_both_generic(x + i, y + i, 8, thr_x, thr_y);
+        }
+    }
+    return i + find_first_above_both_generic(x + i, y + i, num - i, thr_x, thr_y);
+}
+
+template <int K, size_t... J>
+static inline uint32x4_t
+k_above_neon(const float* const* x, const float32x4_t* t, int i, std::index_sequence<J...>)
+{
+    constexpr int n = sizeof...(J);
+    if constexpr (K == n) {
+        uint32x4_t m = vdupq_n_u32(~0u);
+        ((m = vandq_u32(m, vcgtq_f32(vld1q_f32(x[J] + i), t[J]))), ...);
+        return m;
+    } else if constexpr (K == 1) {
+        uint32x4_t m = vdupq_n_u32(0);
+        ((m = vorrq_u32(m, vcgtq_f32(vld1q_f32(x[J] + i), t[J]))), ...);
+        return m;
+    } else {
+        // The masks are all ones per stream above, subtracting them counts
+        uint32x4_t c = vdupq_n_u32(0);
+        ((c = vsubq_u32(c, vcgtq_f32(vld1q_f32(x[J] + i), t[J]))), ...);
+        return vcgtq_u32(c, vdupq_n_u32(K - 1));
+    }
+}
+
+template <int N, int K>
+static int find_first_k_above_neon(const float* const* x, const float* thr, int num)
+{
+    float32x4_t t[N];
+    for (int j = 0; j < N; ++j) {
+        t[j] = vdupq_n_f32(thr[j]);
+    }
+    int i = 0;
+    for (; i + 8 <= num; i += 8) {
+        const uint32x4_t m0 = k_above_neon<K>(x, t, i, std::make_index_sequence<N>());
+        const uint32x4_t m1 = k_above_neon<K>(x, t, i + 4, std::make_index_sequence<N>());
+        if (vmaxvq_u32(vorrq_u32(m0, m1))) {
+            return find_first_k_above_generic<N, K>(x, thr, i, i + 8);
+        }
+    }
+    return find_first_k_above_generic<N, K>(x, thr, i, num);
+}
+
+#endif /* DRONEID_SCAN_NEON */
+
+std::vector<threshold_scan_arch> threshold_scan_archs()
+{
+    std::vector<threshold_scan_arch> archs;
+    archs.push_back({ "generic", find_first_above_generic, find_first_above_both_generic });
+#ifdef DRONEID_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        archs.push_back({ "avx2", find_first_above_avx2, find_first_above_both_avx2 });
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        archs.push_back({ "avx512", find_first_above_avx512, find_first_above_both_avx512 });
+    }
+#endif
+#ifdef DRONEID_SCAN_NEON
+    archs.push_back({ "neon", find_first_above_neon, find_first_above_both_neon });
+#endif
+    return archs;
+}
+
+static const threshold_scan_arch& best_arch()
+{
+    static const threshold_scan_arch arch = threshold_scan_archs().back();
+    return arch;
+}
+
+int find_first_above(const float* x, int num, float thr)
+{
+    return best_arch().above(x, num, thr);
+}
+
+int find_first_above_both(const float* x, const float* y, int num, float thr_x, float thr_y)
+{
+    return best_arch().above_both(x, y, num, thr_x, thr_y);
+}
+
+template <int N, int K>
+int find_first_k_above(const float* const* x, const float* thr, int num)
+{
+    static_assert(N >= 1 && N <= 4 && K >= 1 && K <= N, "1 <= K <= N <= 4");
+    // The single and dual stream AND have their own unrolled kernels
+    if constexpr (N == 1) {
+        return find_first_above(x[0], num, thr[0]);
+    } else if constexpr (N == 2 && K == 2) {
+        return find_first_above_both(x[0], x[1], num, thr[0], thr[1]);
+    } else {
+        typedef int (*fn_t)(const float* const*, const float*, int);
+        static const fn_t fn = [] {
+            fn_t f = [](const float* const* x, const float* thr, int num) {
+                return find_first_k_above_generic<N, K>(x, thr, 0, num);
+            };
+#ifdef DRONEID_SCAN_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                f = find_first_k_above_avx2<N, K>;
+            }
+            if (__builtin_cpu_supports("avx512f")) {
+                f = find_first_k_above_avx512<N, K>;
+            }
+#endif
+#ifdef DRONEID_SCAN_NEON
+            f = find_first_k_above_neon<N, K>;
+#endif
+            return f;
+        }();
+        return fn(x, thr, num);
+    }
+}
+
+template int find_first_k_above<1, 1>(const float* const*, const float*, int);
+template int find_first_k_above<2, 1>(const float* const*, const float*, int);
+template int find_first_k_above<2, 2>(const float* const*, const float*, int);
+template int find_first_k_above<3, 1>(const float* const*, const float*, int);
+template int find_first_k_above<3, 2>(const float* const*, const float*, int);
+template int find_first_k_above<3, 3>(const float* const*, const float*, int);
+template int find_first_k_above<4, 1>(const float* const*, const float*, int);
+template int find_first_k_above<4, 2>(const float* const*, const float*, int);
+template int find_first_k_above<4, 3>(const float* const*, const float*, int);
+template int find_first_k_above<4, 4>(const float* const*, const float*, int);
+
+} // namespace droneid
+} // namespace gr
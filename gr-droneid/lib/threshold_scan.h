@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_THRESHOLD_SCAN_H
+#define INCLUDED_DRONEID_THRESHOLD_SCAN_H
+
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Find the first correlator sample above threshold.
+ *
+ * Both functions return the index of the first hit, or num if there is none.
+ * find_first_above_both() wants x above thr_x and y above thr_y.
+ * The best implementation for the running CPU is picked on first use, the
+ * same way VOLK dispatches its kernels.
+ */
+int find_first_above(const float* x, int num, float thr);
+int find_first_above_both(const float* x, const float* y, int num, float thr_x, float thr_y);
+
+/*
+ * k-of-n combine over N correlator streams: the first sample where at least
+ * K of the x[j] are above their thr[j], or num if there is none. K == N is
+ * an AND, K == 1 an OR. The loop over the streams is unrolled at compile
+ * time, instantiated for N = 1..4.
+ */
+template <int N, int K>
+int find_first_k_above(const float* const* x, const float* thr, int num);
+
+typedef int (*find_first_above_t)(const float*, int, float);
+typedef int (*find_first_above_both_t)(const float*, const float*, int, float, float);
+
+struct threshold_scan_arch {
+    const char* name;
+    find_first_above_t above;
+    find_first_above_both_t above_both;
+};
+
+/*
+ * All implementations the running CPU supports, generic first and the
+ * dispatched one last. Used by the benchmark.
+ */
+std::vector<threshold_scan_arch> threshold_scan_archs();
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_THRESHOLD_SCAN_H */
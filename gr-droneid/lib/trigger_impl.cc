@@ -0,0 +1,263 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "trigger_impl.h"
+#include "threshold_scan.h"
+#include <gnuradio/droneid/dual_trigger.h>
+#include <gnuradio/droneid/multi_trigger.h>
+#include <gnuradio/droneid/single_trigger.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/thread/thread.h>
+#include <algorithm>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * The private constructor
+ */
+template <class Iface, int N, int K>
+trigger_impl<Iface, N, K>::trigger_impl(const char* name,
+                                        float fc,
+                                        float threshold,
+                                        int chunk_size,
+                                        int pre_trigger,
+                                        cfar_mode_t cfar_mode,
+                                        float cfar_threshold_db,
+                                        double samp_rate,
+                                        int holdoff,
+                                        int peak_window)
+    : gr::block(name,
+        gr::io_signature::makev(N + 1, N + 1, [] {
+            // IQ and N correlator streams
+            std::vector<int> sizes(N + 1, sizeof(float));
+            sizes[0] = sizeof(gr_complex);
+            return sizes;
+        }()),
+        gr::io_signature::make(0, 1, sizeof(gr_complex))),
+    m_pre_trigger(pre_trigger),
+    m_armed(true),
+    m_pub(this,
+          fc,
+          threshold,
+          cfar_threshold_db,
+          chunk_size,
+          pre_trigger,
+          -1, // an upstream correlator, where in the burst isn't known
+          samp_rate,
+          MAX_CAPTURES,
+          holdoff,
+          peak_window),
+    m_cfar(N, cfar_estimator(CFAR_CELL, CFAR_CELLS, cfar_mode))
+{
+    m_t1_last_sample = 0.f;
+    // The pre-trigger samples are kept in the input buffer by the scheduler
+    this->set_history(m_pre_trigger + 1);
+    // Room for a whole burst on the stream output, the tags are ours only
+    this->set_min_output_buffer(m_pub.capture_size());
+    this->set_tag_propagation_policy(gr::block::TPP_DONT);
+}
+
+/*
+ * Our virtual destructor.
+ */
+template <class Iface, int N, int K>
+trigger_impl<Iface, N, K>::~trigger_impl() {}
+
+template <class Iface, int N, int K>
+void trigger_impl<Iface, N, K>::set_threshold(float t) {
+    gr::thread::scoped_lock lock(this->d_setlock);
+    m_pub.set_threshold(t);
+}
+
+template <class Iface, int N, int K>
+void trigger_impl<Iface, N, K>::set_fc(float f) {
+    gr::thread::scoped_lock lock(this->d_setlock);
+    m_pub.set_fc(f);
+}
+
+template <class Iface, int N, int K>
+int trigger_impl<Iface, N, K>::active_captures() const {
+    return m_pub.active();
+}
+
+template <class Iface, int N, int K>
+void trigger_impl<Iface, N, K>::set_cfar_mode(cfar_mode_t mode) {
+    gr::thread::scoped_lock lock(this->d_setlock);
+    for (auto& e : m_cfar) {
+        e.set_mode(mode);
+    }
+}
+
+template <class Iface, int N, int K>
+void trigger_impl<Iface, N, K>::set_cfar_threshold_db(float db) {
+    gr::thread::scoped_lock lock(this->d_setlock);
+    m_pub.set_cfar_threshold_db(db);
+}
+
+template <class Iface, int N, int K>
+float trigger_impl<Iface, N, K>::noise_floor() const {
+    return m_cfar[0].noise();
+}
+
+template <class Iface, int N, int K>
+uint64_t trigger_impl<Iface, N, K>::suppressed_triggers() const {
+    return m_pub.suppressed();
+}
+
+template <class Iface, int N, int K>
+void trigger_impl<Iface, N, K>::set_holdoff(int holdoff) {
+    gr::thread::scoped_lock lock(this->d_setlock);
+    m_pub.set_holdoff(holdoff);
+}
+
+template <class Iface, int N, int K>
+void trigger_impl<Iface, N, K>::set_epoch(uint64_t secs, double frac) {
+    gr::thread::scoped_lock lock(this->d_setlock);
+    m_pub.set_epoch(secs, frac);
+}
+
+template <class Iface, int N, int K>
+bool trigger_impl<Iface, N, K>::combined_above(const std::array<const float*, N>& t,
+                                               const std::array<float, N>& thr,
+                                               int32_t i) const {
+    int above = 0;
+    for (int j = 0; j < N; ++j) {
+        above += t[j][i] > thr[j];
+    }
+    return above >= K;
+}
+
+template <class Iface, int N, int K>
+int trigger_impl<Iface, N, K>::finish(int consumed)
+{
+    for (const auto& tag : m_pub.tags()) {
+        this->add_item_tag(0, tag);
+    }
+    this->consume_each(consumed);
+    return m_pub.produced();
+}
+
+template <class Iface, int N, int K>
+void trigger_impl<Iface, N, K>::forecast(int noutput_items, gr_vector_int& ninput_items_required)
+{
+    // Input is scanned in whole CFAR cells, whatever the output wants. The
+    // partial cell at the end of a finite stream is left, see trigger_impl.h.
+    std::fill(ninput_items_required.begin(),
+              ninput_items_required.end(),
+              CFAR_CELL + (int)this->history() - 1);
+}
+
+template <class Iface, int N, int K>
+int trigger_impl<Iface, N, K>::general_work(int noutput_items,
+                                            gr_vector_int& ninput_items,
+                                            gr_vector_const_void_star& input_items,
+                                            gr_vector_void_star& output_items)
+{
+    m_pub.begin(output_items.empty() ? nullptr : static_cast<gr_complex*>(output_items[0]),
+                noutput_items,
+                this->nitems_written(0));
+
+    // Bursts held back by a full output go first. Until they are out the
+    // input stays where it is, which is the backpressure upstream.
+    if (!m_pub.publish()) {
+        return finish(0);
+    }
+
+    // ninput_items counts the history, whole cells of new samples are scanned
+    const int available = *std::min_element(ninput_items.begin(), ninput_items.end()) -
+                          (int)this->history() + 1;
+    const int nitems = (available / CFAR_CELL) * CFAR_CELL;
+    if (nitems <= 0) {
+        return finish(0);
+    }
+
+    auto in = static_cast<const gr_complex*>(input_items[0]);
+    std::array<const float*, N> t;
+    for (int j = 0; j < N; ++j) {
+        t[j] = static_cast<const float*>(input_items[j + 1]) + m_pre_trigger;
+    }
+    const float* t1 = t[0];
+    const uint64_t first = this->nitems_read(0);
+
+    // Cell by cell, and no further than the cell where the stream output
+    // filled up. The bursts after it wait in the input, not in the captures.
+    // The thresholds are constant over a cell and come from the cells before it.
+    int32_t cell = 0;
+    bool room = true;
+    for (; cell < nitems && room; cell += CFAR_CELL) {
+        const int32_t end = cell + CFAR_CELL;
+        std::vector<tag_t> tags;
+        this->get_tags_in_range(tags, 0, first + cell, first + end);
+        m_pub.update(tags);
+
+        // With history, in[m_pre_trigger] is the first new sample of this call.
+        // Captures started before this cell get its samples first.
+        m_pub.feed(in + m_pre_trigger + cell, CFAR_CELL);
+        m_pub.track(t1 + cell, CFAR_CELL, first + cell);
+        room = m_pub.publish();
+
+        std::array<float, N> thr;
+        for (int j = 0; j < N; ++j) {
+            thr[j] = m_pub.threshold(m_cfar[j]);
+        }
+        int32_t pos = cell;
+        while (pos < end) {
+            if (!m_armed) {
+                // Re-arm once the combined condition no longer holds
+                while (pos < end && combined_above(t, thr, pos)) {
+                    pos++;
+                }
+                if (pos == end) {
+                    break;
+                }
+                m_armed = true;
+            }
+            std::array<const float*, N> tp;
+            for (int j = 0; j < N; ++j) {
+                tp[j] = t[j] + pos;
+            }
+            const int32_t idx = pos + find_first_k_above<N, K>(tp.data(), thr.data(), end - pos);
+            if (idx == end) {
+                break;
+            }
+            m_armed = false;
+            pos = idx + 1;
+            // Collect [trigger - pre, trigger + chunk) straight from the input buffer
+            // up to the end of the cell, the next cells feed the rest, and look
+            // for the correlator peak after the trigger
+            const float prev = idx ? t1[idx - 1] : m_t1_last_sample;
+            if (!m_pub.trigger(in + idx, end + m_pre_trigger - idx, first + idx, prev)) {
+                continue;
+            }
+            m_pub.track(t1 + idx, end - idx, first + idx);
+            room = m_pub.publish();
+        }
+        for (int j = 0; j < N; ++j) {
+            m_cfar[j].update(t[j] + cell);
+        }
+        m_t1_last_sample = t1[end - 1];
+    }
+    m_pub.advance(first + cell);
+    return finish(cell);
+}
+
+template class trigger_impl<single_trigger, 1, 1>;
+template class trigger_impl<dual_trigger, 2, 2>;
+template class trigger_impl<multi_trigger, 1, 1>;
+template class trigger_impl<multi_trigger, 2, 1>;
+template class trigger_impl<multi_trigger, 2, 2>;
+template class trigger_impl<multi_trigger, 3, 1>;
+template class trigger_impl<multi_trigger, 3, 2>;
+template class trigger_impl<multi_trigger, 3, 3>;
+template class trigger_impl<multi_trigger, 4, 1>;
+template class trigger_impl<multi_trigger, 4, 2>;
+template class trigger_impl<multi_trigger, 4, 3>;
+template class trigger_impl<multi_trigger, 4, 4>;
+
+} /* namespace droneid */
+} /* namespace gr */
@@ -0,0 +1,99 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_TRIGGER_IMPL_H
+#define INCLUDED_DRONEID_TRIGGER_IMPL_H
+
+#include "capture_publisher.h"
+#include "cfar_estimator.h"
+#include <gnuradio/block.h>
+#include <array>
+#include <vector>
+
+namespace gr {
+namespace droneid {
+
+/*
+ * Correlator trigger on N detector streams.
+ *
+ * Input 0 is IQ, inputs 1..N the correlator outputs. A trigger fires where
+ * at least K of the N streams are above their threshold, K == N being an
+ * AND and K == 1 an OR. Both are template parameters, so each instantiation
+ * gets its own unrolled scan kernel and there is no loop over the inputs in
+ * the hot path. Every stream has its own CFAR noise floor, the TOA and the
+ * burst peak are taken from the first one.
+ *
+ * The captures, their metadata and the output are capture_publisher's.
+ * Bursts go out as PDUs, or on the stream output when it is connected. The
+ * stream output is written from the pooled capture vectors, a burst that
+ * doesn't fit continues in the next call and no new input is taken until
+ * it is out. The scan stops at the end of the cell where the output filled
+ * up, so the bursts after it wait in the input and none is dropped.
+ *
+ * Input is only scanned in whole CFAR cells. At the end of a finite stream
+ * the last partial cell is never scanned, a burst triggering there is lost.
+ * Its capture couldn't complete anyway unless chunk_size is shorter than
+ * a cell, as the samples after the trigger never come.
+ *
+ * The setters take the set lock, work() runs with it held, so a change
+ * lands between two calls and never halfway through a scan.
+ *
+ * Iface is the public block class, single_trigger, dual_trigger and
+ * multi_trigger are all instantiations of this.
+ */
+template <class Iface, int N, int K>
+class trigger_impl : public Iface
+{
+    static_assert(N >= 1 && N <= 4 && K >= 1 && K <= N, "1 <= K <= N <= 4");
+
+private:
+    static constexpr int MAX_CAPTURES = 16;
+    // CFAR noise cells, work() consumes whole cells of this many samples
+    static constexpr int CFAR_CELL = 1024;
+    static constexpr int CFAR_CELLS = 16;
+    float m_t1_last_sample;
+    int32_t m_pre_trigger;
+    bool m_armed;
+    capture_publisher m_pub;
+    std::vector<cfar_estimator> m_cfar;
+    int finish(int consumed);
+    bool combined_above(const std::array<const float*, N>& t,
+                        const std::array<float, N>& thr,
+                        int32_t i) const;
+
+public:
+    trigger_impl(const char* name,
+                 float fc,
+                 float threshold,
+                 int chunk_size,
+                 int pre_trigger,
+                 cfar_mode_t cfar_mode,
+                 float cfar_threshold_db,
+                 double samp_rate,
+                 int holdoff,
+                 int peak_window);
+    ~trigger_impl();
+    void set_threshold(float t) override;
+    void set_fc(float f) override;
+    int active_captures() const override;
+    void set_cfar_mode(cfar_mode_t mode) override;
+    void set_cfar_threshold_db(float db) override;
+    float noise_floor() const override;
+    uint64_t suppressed_triggers() const override;
+    void set_holdoff(int holdoff) override;
+    void set_epoch(uint64_t secs, double frac) override;
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required);
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items);
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_TRIGGER_IMPL_H */
@@ -0,0 +1,401 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "zc_detector_impl.h"
+#include "threshold_scan.h"
+#include <gnuradio/droneid/utilities.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/thread/thread.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gr {
+namespace droneid {
+
+zc_detector::sptr zc_detector::make(float fc,
+                                    float threshold,
+                                    int chunk_size,
+                                    int pre_trigger,
+                                    double samp_rate,
+                                    cfar_mode_t cfar_mode,
+                                    float cfar_threshold_db,
+                                    float coarse_threshold,
+                                    int holdoff,
+                                    int peak_window)
+{
+    return gnuradio::make_block_sptr<zc_detector_impl>(fc,
+                                                       threshold,
+                                                       chunk_size,
+                                                       pre_trigger,
+                                                       samp_rate,
+                                                       cfar_mode,
+                                                       cfar_threshold_db,
+                                                       coarse_threshold,
+                                                       holdoff,
+                                                       peak_window);
+}
+
+
+/*
+ * The private constructor
+ */
+zc_detector_impl::zc_detector_impl(float fc,
+                                   float threshold,
+                                   int chunk_size,
+                                   int pre_trigger,
+                                   double samp_rate,
+                                   cfar_mode_t cfar_mode,
+                                   float cfar_threshold_db,
+                                   float coarse_threshold,
+                                   int holdoff,
+                                   int peak_window)
+    : gr::block("zc_detector",
+                gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                gr::io_signature::make(0, 1, sizeof(gr_complex))),
+      m_pub(this,
+            fc,
+            threshold,
+            cfar_threshold_db,
+            chunk_size,
+            pre_trigger,
+            zc4_offset(samp_rate),
+            samp_rate,
+            MAX_CAPTURES,
+            holdoff,
+            peak_window),
+      m_cfar1(fft_size(samp_rate), CFAR_CELLS, cfar_mode),
+      m_cfar2(fft_size(samp_rate), CFAR_CELLS, cfar_mode),
+      m_coarse_p(short_cp(samp_rate) / COARSE_DECIM, 0),
+      m_coarse_ea(short_cp(samp_rate) / COARSE_DECIM, 0.f),
+      m_coarse_eb(short_cp(samp_rate) / COARSE_DECIM, 0.f),
+      m_coarse_next(0),
+      m_coarse_count(0),
+      m_p_sum(0.),
+      m_ea_sum(0.),
+      m_eb_sum(0.),
+      m_blocks(0),
+      m_skipped(0)
+{
+    m_pre_trigger = pre_trigger;
+    m_armed = true;
+    m_t1_last_sample = 0.f;
+    m_pub.set_extra_meta([this](const capture_publisher::meta_fn& add) {
+        add("skipped", pmt::mp(skipped_fraction()));
+    });
+
+    m_fft_size = fft_size(samp_rate);
+    m_ols_size = OLS_FACTOR * m_fft_size;
+    m_step = m_ols_size - m_fft_size;
+    m_delay = zc_distance(samp_rate);
+    m_zc4 = zc4_offset(samp_rate);
+    m_burst_len = burst_length(samp_rate);
+    // A CP hit anywhere in a burst still finds the symbol 4 block ahead
+    m_lookahead = m_burst_len;
+    set_coarse_threshold(coarse_threshold);
+
+    m_fwd = std::make_unique<gr::fft::fft_complex_fwd>(m_ols_size);
+    m_rev = std::make_unique<gr::fft::fft_complex_rev>(m_ols_size);
+    m_h4.resize(m_ols_size);
+    m_h6.resize(m_ols_size);
+    make_template(ZC_ROOT_SYMBOL_4, m_h4.data());
+    make_template(ZC_ROOT_SYMBOL_6, m_h6.data());
+    m_t1.assign(m_delay + m_step, 0.f);
+    m_t2.assign(m_step, 0.f);
+
+    // The correlator needs one symbol after its start sample, and the capture
+    // reaches back from symbol 6 to symbol 4 and then pre_trigger further.
+    // The correlator also lags the coarse stage by m_lookahead.
+    set_history(m_fft_size + m_delay + m_pre_trigger + m_lookahead + 1);
+    // Room for a whole burst on the stream output, the tags are ours only
+    set_min_output_buffer(m_pub.capture_size());
+    set_tag_propagation_policy(TPP_DONT);
+}
+
+/*
+ * Our virtual destructor.
+ */
+zc_detector_impl::~zc_detector_impl() {}
+
+void zc_detector_impl::set_threshold(float t) {
+    gr::thread::scoped_lock lock(d_setlock);
+    m_pub.set_threshold(t);
+}
+
+void zc_detector_impl::set_fc(float f) {
+    gr::thread::scoped_lock lock(d_setlock);
+    m_pub.set_fc(f);
+}
+
+int zc_detector_impl::active_captures() const {
+    return m_pub.active();
+}
+
+void zc_detector_impl::set_cfar_mode(cfar_mode_t mode) {
+    gr::thread::scoped_lock lock(d_setlock);
+    m_cfar1.set_mode(mode);
+    m_cfar2.set_mode(mode);
+}
+
+void zc_detector_impl::set_cfar_threshold_db(float db) {
+    gr::thread::scoped_lock lock(d_setlock);
+    m_pub.set_cfar_threshold_db(db);
+}
+
+float zc_detector_impl::noise_floor() const {
+    return m_cfar1.noise();
+}
+
+void zc_detector_impl::set_coarse_threshold(float t) {
+    gr::thread::scoped_lock lock(d_setlock);
+    m_coarse_thr = t;
+}
+
+double zc_detector_impl::skipped_fraction() const {
+    return m_blocks ? (double)m_skipped / m_blocks : 0.;
+}
+
+uint64_t zc_detector_impl::suppressed_triggers() const {
+    return m_pub.suppressed();
+}
+
+void zc_detector_impl::set_holdoff(int holdoff) {
+    gr::thread::scoped_lock lock(d_setlock);
+    m_pub.set_holdoff(holdoff);
+}
+
+void zc_detector_impl::set_epoch(uint64_t secs, double frac) {
+    gr::thread::scoped_lock lock(d_setlock);
+    m_pub.set_epoch(secs, frac);
+}
+
+void zc_detector_impl::make_template(int root, gr_complex* h) {
+    // Same sequence as utilities.create_zc_sequence()
+    const int n = m_fft_size;
+    const int lguard = (n - DATA_CARRIERS) / 2;
+    std::vector<gr_complex> zc_w(n, 0);
+    for (int idx = 0; idx <= DATA_CARRIERS; ++idx) {
+        const double x = -M_PI * root * idx * (idx + 1.0) / (DATA_CARRIERS + 1);
+        zc_w[idx + lguard] = gr_complex(std::cos(x), std::sin(x));
+    }
+    zc_w[n / 2] = 0;
+
+    // ifft(fftshift(zc_w))
+    gr::fft::fft_complex_rev ifft(n);
+    for (int k = 0; k < n; ++k) {
+        ifft.get_inbuf()[k] = zc_w[(k + n / 2) % n];
+    }
+    ifft.execute();
+
+    // Zero padded to the overlap-save length, both inverse FFTs scaled here
+    const float scale = 1.f / ((float)n * (float)m_ols_size);
+    gr_complex* buf = m_fwd->get_inbuf();
+    std::fill(buf, buf + m_ols_size, gr_complex(0));
+    for (int k = 0; k < n; ++k) {
+        buf[k] = ifft.get_outbuf()[k] * scale;
+    }
+    m_fwd->execute();
+    memcpy(h, m_fwd->get_outbuf(), m_ols_size * sizeof(gr_complex));
+}
+
+void zc_detector_impl::correlate(const gr_complex* h, float* t) {
+    // c[n] = sum_k x[n + k] conj(zc[k]), valid for the first m_step outputs
+    volk_32fc_x2_multiply_conjugate_32fc(m_rev->get_inbuf(), m_fwd->get_outbuf(), h, m_ols_size);
+    m_rev->execute();
+    volk_32fc_magnitude_squared_32f(t, m_rev->get_outbuf(), m_step);
+}
+
+void zc_detector_impl::coarse(const gr_complex* x, int num, uint64_t first) {
+    // x[i] is item first + i and x[i - m_fft_size] is readable. Every
+    // COARSE_DECIM-th item by absolute count, so calls line up.
+    const double thr2 = (double)m_coarse_thr * m_coarse_thr;
+    const size_t len = m_coarse_p.size();
+    for (int32_t i = (COARSE_DECIM - first % COARSE_DECIM) % COARSE_DECIM; i < num;
+         i += COARSE_DECIM) {
+        const gr_complex a = x[i - m_fft_size];
+        const gr_complex b = x[i];
+        const gr_complex p = a * std::conj(b);
+        const float ea = std::norm(a);
+        const float eb = std::norm(b);
+        // Running sums over one CP, the oldest pair leaves as the new one comes in
+        m_p_sum += std::complex<double>(p) - std::complex<double>(m_coarse_p[m_coarse_next]);
+        m_ea_sum += ea - m_coarse_ea[m_coarse_next];
+        m_eb_sum += eb - m_coarse_eb[m_coarse_next];
+        m_coarse_p[m_coarse_next] = p;
+        m_coarse_ea[m_coarse_next] = ea;
+        m_coarse_eb[m_coarse_next] = eb;
+        m_coarse_next = (m_coarse_next + 1) % len;
+        m_coarse_count = std::min(m_coarse_count + 1, len);
+
+        // |P|^2 > thr^2 Ea Eb, i.e. the CP and its copy are coherent
+        if (m_coarse_count == len && std::norm(m_p_sum) > thr2 * m_ea_sum * m_eb_sum) {
+            add_window(first + i);
+        }
+    }
+}
+
+void zc_detector_impl::add_window(int64_t item) {
+    // item ends a CP copy somewhere in a burst, so the burst starts at most
+    // m_burst_len before it. Cover symbol 4 of the earliest such burst to
+    // symbol 6 of the latest, with a symbol of margin on both sides.
+    const int64_t from = item - m_burst_len + m_zc4 - m_fft_size;
+    const int64_t to = item + m_zc4 + m_delay + m_fft_size;
+    if (!m_windows.empty() && from <= m_windows.back().second) {
+        m_windows.back().second = std::max(m_windows.back().second, to);
+    } else {
+        m_windows.emplace_back(from, to);
+    }
+}
+
+bool zc_detector_impl::fine_wanted(int64_t first, int64_t last) {
+    if (m_coarse_thr <= 0.f) {
+        return true;
+    }
+    // Windows are in order and the blocks come in order
+    while (!m_windows.empty() && m_windows.front().second < first) {
+        m_windows.pop_front();
+    }
+    return !m_windows.empty() && m_windows.front().first < last;
+}
+
+int zc_detector_impl::finish(int consumed)
+{
+    for (const auto& tag : m_pub.tags()) {
+        add_item_tag(0, tag);
+    }
+    consume_each(consumed);
+    return m_pub.produced();
+}
+
+void zc_detector_impl::forecast(int noutput_items, gr_vector_int& ninput_items_required)
+{
+    // Input is correlated in whole overlap-save blocks, whatever the output wants
+    ninput_items_required[0] = m_step + (int)history() - 1;
+}
+
+int zc_detector_impl::general_work(int noutput_items,
+                                   gr_vector_int& ninput_items,
+                                   gr_vector_const_void_star& input_items,
+                                   gr_vector_void_star& output_items)
+{
+    m_pub.begin(output_items.empty() ? nullptr : static_cast<gr_complex*>(output_items[0]),
+                noutput_items,
+                nitems_written(0));
+
+    // Bursts held back by a full output go first. Until they are out the
+    // input stays where it is, which is the backpressure upstream.
+    if (!m_pub.publish()) {
+        return finish(0);
+    }
+
+    // With history, in[hist] is the first new sample of this call and
+    // ninput_items counts the history. Whole overlap-save blocks are taken.
+    const int32_t hist = history() - 1;
+    const int nitems = (ninput_items[0] - hist) / m_step * m_step;
+    if (nitems <= 0) {
+        return finish(0);
+    }
+    auto in = static_cast<const gr_complex*>(input_items[0]);
+
+    // Block by block, and no further than the block where the stream output
+    // filled up. The bursts after it wait in the input, not in the captures.
+    int32_t blk = 0;
+    bool room = true;
+    for (; blk < nitems && room; blk += m_step) {
+        std::vector<tag_t> tags;
+        get_tags_in_range(tags, 0, nitems_read(0) + blk, nitems_read(0) + blk + m_step);
+        m_pub.update(tags);
+        m_pub.feed(in + hist + blk, m_step);
+
+        // The coarse stage sees the new samples, the correlator runs
+        // m_lookahead behind it
+        if (m_coarse_thr > 0.f) {
+            coarse(in + hist + blk, m_step, nitems_read(0) + blk);
+        }
+
+        // Correlator outputs for symbols starting at new sample
+        // blk - m_fft_size - m_lookahead onwards
+        const int32_t base = hist + blk - m_fft_size - m_lookahead;
+        const int64_t base_item = (int64_t)nitems_read(0) + base - hist;
+        const bool fine = fine_wanted(base_item, base_item + m_step);
+        m_blocks++;
+
+        // t1[i] is symbol 4 two symbols before t2[i]
+        memmove(m_t1.data(), m_t1.data() + m_step, m_delay * sizeof(float));
+        if (fine) {
+            memcpy(m_fwd->get_inbuf(), in + base, m_ols_size * sizeof(gr_complex));
+            m_fwd->execute();
+            correlate(m_h4.data(), m_t1.data() + m_delay);
+            correlate(m_h6.data(), m_t2.data());
+        } else {
+            // Nothing near a CP hit, the correlator would only see noise
+            std::fill(m_t1.begin() + m_delay, m_t1.end(), 0.f);
+            std::fill(m_t2.begin(), m_t2.end(), 0.f);
+            m_skipped++;
+        }
+        const float* t1 = m_t1.data();
+        const float* t2 = m_t2.data();
+        // Item of t1[0], the trigger and TOA refer to symbol 4
+        const uint64_t t1_item = nitems_read(0) + base - m_delay - hist;
+        m_pub.track(t1, m_step, t1_item);
+        room = m_pub.publish();
+        if (!fine) {
+            // Keep the noise floor to correlated blocks, re-arm on the zeros
+            m_armed = true;
+            m_t1_last_sample = 0.f;
+            continue;
+        }
+
+        // The threshold is constant over a symbol long cell and comes from
+        // the cells before it
+        for (int32_t cell = 0; cell < m_step; cell += m_fft_size) {
+            const float thr1 = m_pub.threshold(m_cfar1);
+            const float thr2 = m_pub.threshold(m_cfar2);
+            const int32_t end = cell + m_fft_size;
+            int32_t pos = cell;
+            while (pos < end) {
+                if (!m_armed) {
+                    // Re-arm once either correlator has dropped below threshold
+                    while (pos < end && t1[pos] > thr1 && t2[pos] > thr2) {
+                        pos++;
+                    }
+                    if (pos == end) {
+                        break;
+                    }
+                    m_armed = true;
+                }
+                const int32_t idx = pos + find_first_above_both(t1 + pos, t2 + pos, end - pos, thr1, thr2);
+                if (idx == end) {
+                    break;
+                }
+                m_armed = false;
+                pos = idx + 1;
+                // The trigger sample is the start of the symbol 4 FFT window
+                const int32_t start = base + idx - m_delay - m_pre_trigger;
+                const float prev = idx ? t1[idx - 1] : m_t1_last_sample;
+                // The capture gets the input up to the end of this block
+                if (!m_pub.trigger(in + start, hist + blk + m_step - start, t1_item + idx, prev)) {
+                    continue;
+                }
+                m_pub.track(t1 + idx, m_step - idx, t1_item + idx);
+                room = m_pub.publish();
+            }
+            m_cfar1.update(t1 + cell);
+            m_cfar2.update(t2 + cell);
+        }
+        m_t1_last_sample = t1[m_step - 1];
+    }
+    // The correlator, and so the triggers, are this far behind the input
+    const int64_t scanned = (int64_t)nitems_read(0) + blk - m_fft_size - m_lookahead - m_delay;
+    if (scanned > 0) {
+        m_pub.advance(scanned);
+    }
+    return finish(blk);
+}
+
+} /* namespace droneid */
+} /* namespace gr */
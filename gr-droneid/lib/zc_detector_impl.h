@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Magnus Lundmark.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DRONEID_ZC_DETECTOR_IMPL_H
+#define INCLUDED_DRONEID_ZC_DETECTOR_IMPL_H
+
+#include <gnuradio/droneid/zc_detector.h>
+#include "capture_publisher.h"
+#include "cfar_estimator.h"
+#include <gnuradio/fft/fft.h>
+#include <volk/volk.h>
+#include <volk/volk_alloc.hh>
+#include <complex>
+#include <deque>
+#include <memory>
+
+namespace gr {
+namespace droneid {
+
+class zc_detector_impl : public zc_detector
+{
+private:
+    static constexpr int MAX_CAPTURES = 16;
+    static constexpr int CFAR_CELLS = 16;
+    // Overlap-save FFT length in OFDM symbols
+    static constexpr int OLS_FACTOR = 4;
+    // Coarse stage CP autocorrelation on every 4th sample
+    static constexpr int COARSE_DECIM = 4;
+    float m_t1_last_sample;
+    int32_t m_pre_trigger;
+    int32_t m_fft_size;  // OFDM symbol, also the template length
+    int32_t m_ols_size;  // overlap-save FFT length
+    int32_t m_step;      // new correlator outputs per overlap-save block
+    int32_t m_delay;     // symbol 4 to symbol 6 distance
+    int32_t m_zc4;       // burst start to the symbol 4 FFT window
+    int32_t m_burst_len;
+    int32_t m_lookahead; // samples the coarse stage runs ahead of the correlator
+    bool m_armed;
+    capture_publisher m_pub;
+    // One OFDM symbol per cell
+    cfar_estimator m_cfar1;
+    cfar_estimator m_cfar2;
+    std::unique_ptr<gr::fft::fft_complex_fwd> m_fwd;
+    std::unique_ptr<gr::fft::fft_complex_rev> m_rev;
+    // FFT(zc) / ols_size for symbol 4 and 6, applied conjugated
+    volk::vector<gr_complex> m_h4;
+    volk::vector<gr_complex> m_h6;
+    // |c4|^2 with m_delay samples of the previous block in front
+    volk::vector<float> m_t1;
+    volk::vector<float> m_t2;
+    // Coarse stage, x[n - N] conj(x[n]) and both energies over one CP
+    float m_coarse_thr;
+    std::vector<gr_complex> m_coarse_p;
+    std::vector<float> m_coarse_ea;
+    std::vector<float> m_coarse_eb;
+    size_t m_coarse_next;
+    size_t m_coarse_count;
+    std::complex<double> m_p_sum;
+    double m_ea_sum;
+    double m_eb_sum;
+    // Correlator positions, as items, the fine stage has to cover
+    std::deque<std::pair<int64_t, int64_t>> m_windows;
+    uint64_t m_blocks;
+    uint64_t m_skipped;
+    void coarse(const gr_complex* x, int num, uint64_t first);
+    void add_window(int64_t item);
+    bool fine_wanted(int64_t first, int64_t last);
+    void make_template(int root, gr_complex* h);
+    void correlate(const gr_complex* h, float* t);
+    int finish(int consumed);
+
+public:
+    zc_detector_impl(float fc,
+                     float threshold,
+                     int chunk_size,
+                     int pre_trigger,
+                     double samp_rate,
+                     cfar_mode_t cfar_mode,
+                     float cfar_threshold_db,
+                     float coarse_threshold,
+                     int holdoff,
+                     int peak_window);
+    ~zc_detector_impl();
+    void set_threshold(float t) override;
+    void set_fc(float f) override;
+    int active_captures() const override;
+    void set_cfar_mode(cfar_mode_t mode) override;
+    void set_cfar_threshold_db(float db) override;
+    float noise_floor() const override;
+    void set_coarse_threshold(float t) override;
+    double skipped_fraction() const override;
+    uint64_t suppressed_triggers() const override;
+    void set_holdoff(int holdoff) override;
+    void set_epoch(uint64_t secs, double frac) override;
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
+};
+
+} // namespace droneid
+} // namespace gr
+
+#endif /* INCLUDED_DRONEID_ZC_DETECTOR_IMPL_H */
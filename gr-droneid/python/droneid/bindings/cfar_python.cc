@@ -0,0 +1,41 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(cfar.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(61198097cd3bd8dfc63eb300ff6766ec)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/droneid/cfar.h>
+// pydoc.h is automatically generated in the build directory
+#include <cfar_pydoc.h>
+
+void bind_cfar(py::module& m)
+{
+
+
+    py::enum_<::gr::droneid::cfar_mode_t>(m, "cfar_mode_t")
+        .value("CFAR_OFF", ::gr::droneid::CFAR_OFF) // 0
+        .value("CFAR_CA", ::gr::droneid::CFAR_CA)   // 1
+        .value("CFAR_OS", ::gr::droneid::CFAR_OS)   // 2
+        .export_values();
+
+    py::implicitly_convertible<int, ::gr::droneid::cfar_mode_t>();
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(channelizer.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(d113823e0dfa1ba86b901bf373890e25)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/droneid/channelizer.h>
+// pydoc.h is automatically generated in the build directory
+#include <channelizer_pydoc.h>
+
+void bind_channelizer(py::module& m)
+{
+
+    using channelizer    = ::gr::droneid::channelizer;
+
+
+    py::class_<channelizer, gr::sync_decimator, gr::sync_block, gr::block, gr::basic_block,
+        std::shared_ptr<channelizer>>(m, "channelizer", D(channelizer))
+
+        .def(py::init(&channelizer::make),
+           py::arg("samp_rate"),
+           py::arg("center_freq"),
+           py::arg("channel_freqs"),
+           py::arg("decimation") = 4,
+           py::arg("num_bins") = 8,
+           py::arg("taps") = std::vector<float>(),
+           D(channelizer,make)
+        )
+        
+
+
+
+
+        
+        .def("set_center_freq",&channelizer::set_center_freq,       
+            py::arg("arg0"),
+            D(channelizer,set_center_freq)
+        )
+
+
+        
+        .def("center_freq",&channelizer::center_freq,       
+            D(channelizer,center_freq)
+        )
+
+
+        
+        .def("channel_freqs",&channelizer::channel_freqs,       
+            D(channelizer,channel_freqs)
+        )
+
+        ;
+
+
+
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(decoder.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(531e18e2fe56dd4c2df6d531ad33a3d0)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/droneid/decoder.h>
+// pydoc.h is automatically generated in the build directory
+#include <decoder_pydoc.h>
+
+void bind_decoder(py::module& m)
+{
+
+    using decoder    = ::gr::droneid::decoder;
+
+
+    py::class_<decoder, gr::block, gr::basic_block,
+        std::shared_ptr<decoder>>(m, "decoder", D(decoder))
+
+        .def(py::init(&decoder::make),
+           py::arg("samp_rate") = 15.36e6,
+           py::arg("crc_only") = false,
+           py::arg("threads") = 1,
+           py::arg("queue_depth") = 16,
+           D(decoder,make)
+        )
+        
+
+
+
+        .def("frames_ok",&decoder::frames_ok,       
+            D(decoder,frames_ok)
+        )
+
+        .def("frames_failed",&decoder::frames_failed,       
+            D(decoder,frames_failed)
+        )
+
+
+        .def("frames_dropped",&decoder::frames_dropped,       
+            D(decoder,frames_dropped)
+        )
+
+
+        .def("queue_depth",&decoder::queue_depth,       
+            D(decoder,queue_depth)
+        )
+
+
+        .def("utilisation",&decoder::utilisation,       
+            D(decoder,utilisation)
+        )
+
+        ;
+
+
+
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr,droneid, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+ 
+ static const char *__doc_gr_droneid_channelizer = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_channelizer_channelizer_0 = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_channelizer_channelizer_1 = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_channelizer_make = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_channelizer_set_center_freq = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_channelizer_center_freq = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_channelizer_channel_freqs = R"doc()doc";
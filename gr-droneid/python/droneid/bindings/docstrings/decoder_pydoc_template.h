@@ -0,0 +1,44 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr,droneid, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+ 
+ static const char *__doc_gr_droneid_decoder = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_decoder_0 = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_decoder_1 = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_make = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_frames_ok = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_frames_failed = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_frames_dropped = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_queue_depth = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_decoder_utilisation = R"doc()doc";
+
+  
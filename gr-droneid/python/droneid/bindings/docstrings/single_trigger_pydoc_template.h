@@ -33,4 +33,25 @@
 
  static const char *__doc_gr_droneid_single_trigger_set_fc = R"doc()doc";
 
+
+ static const char *__doc_gr_droneid_single_trigger_active_captures = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_single_trigger_set_cfar_mode = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_single_trigger_set_cfar_threshold_db = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_single_trigger_noise_floor = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_single_trigger_suppressed_triggers = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_single_trigger_set_holdoff = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_single_trigger_set_epoch = R"doc()doc";
+
   
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr,droneid, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+ 
+ static const char *__doc_gr_droneid_zc_detector = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_zc_detector_0 = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_zc_detector_1 = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_make = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_set_threshold = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_set_fc = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_active_captures = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_set_cfar_mode = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_set_cfar_threshold_db = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_noise_floor = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_set_coarse_threshold = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_skipped_fraction = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_suppressed_triggers = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_set_holdoff = R"doc()doc";
+
+
+ static const char *__doc_gr_droneid_zc_detector_set_epoch = R"doc()doc";
+
+  
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(dual_trigger.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(5fbd1d1d63609284af590e64dc0a28a8)                     */
+/* BINDTOOL_HEADER_FILE_HASH(7500110e0e88746378ab7c3a885b7512)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -33,13 +33,19 @@ void bind_dual_trigger(py::module& m)
     using dual_trigger    = ::gr::droneid::dual_trigger;
 
 
-    py::class_<dual_trigger, gr::sync_block, gr::block, gr::basic_block,
+    py::class_<dual_trigger, gr::block, gr::basic_block,
         std::shared_ptr<dual_trigger>>(m, "dual_trigger", D(dual_trigger))
 
         .def(py::init(&dual_trigger::make),
            py::arg("fc"),
            py::arg("threshold"),
            py::arg("chunk_size"),
+           py::arg("pre_trigger") = 0,
+           py::arg("cfar_mode") = ::gr::droneid::CFAR_OFF,
+           py::arg("cfar_threshold_db") = 12.f,
+           py::arg("samp_rate") = 15.36e6,
+           py::arg("holdoff") = 0,
+           py::arg("peak_window") = 16,
            D(dual_trigger,make)
         )
         
@@ -60,6 +66,46 @@ void bind_dual_trigger(py::module& m)
             D(dual_trigger,set_fc)
         )
 
+
+        .def("active_captures",&dual_trigger::active_captures,       
+            D(dual_trigger,active_captures)
+        )
+
+
+        .def("set_cfar_mode",&dual_trigger::set_cfar_mode,       
+            py::arg("arg0"),
+            D(dual_trigger,set_cfar_mode)
+        )
+
+
+        .def("set_cfar_threshold_db",&dual_trigger::set_cfar_threshold_db,       
+            py::arg("arg0"),
+            D(dual_trigger,set_cfar_threshold_db)
+        )
+
+
+        .def("noise_floor",&dual_trigger::noise_floor,       
+            D(dual_trigger,noise_floor)
+        )
+
+
+        .def("suppressed_triggers",&dual_trigger::suppressed_triggers,       
+            D(dual_trigger,suppressed_triggers)
+        )
+
+
+        .def("set_holdoff",&dual_trigger::set_holdoff,       
+            py::arg("arg0"),
+            D(dual_trigger,set_holdoff)
+        )
+
+
+        .def("set_epoch",&dual_trigger::set_epoch,       
+            py::arg("secs"),
+            py::arg("frac"),
+            D(dual_trigger,set_epoch)
+        )
+
         ;
 
 
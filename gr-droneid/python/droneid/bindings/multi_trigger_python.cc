@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(multi_trigger.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(58279a3c5aeab68a60f3cbea5afa1182)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/droneid/multi_trigger.h>
+// pydoc.h is automatically generated in the build directory
+#include <multi_trigger_pydoc.h>
+
+void bind_multi_trigger(py::module& m)
+{
+
+    using multi_trigger    = ::gr::droneid::multi_trigger;
+
+
+    py::class_<multi_trigger, gr::block, gr::basic_block,
+        std::shared_ptr<multi_trigger>>(m, "multi_trigger", D(multi_trigger))
+
+        .def(py::init(&multi_trigger::make),
+           py::arg("num_inputs"),
+           py::arg("k"),
+           py::arg("fc"),
+           py::arg("threshold"),
+           py::arg("chunk_size"),
+           py::arg("pre_trigger") = 0,
+           py::arg("cfar_mode") = ::gr::droneid::CFAR_OFF,
+           py::arg("cfar_threshold_db") = 12.f,
+           py::arg("samp_rate") = 15.36e6,
+           py::arg("holdoff") = 0,
+           py::arg("peak_window") = 16,
+           D(multi_trigger,make)
+        )
+        
+
+
+
+
+        
+        .def("set_threshold",&multi_trigger::set_threshold,       
+            py::arg("arg0"),
+            D(multi_trigger,set_threshold)
+        )
+
+
+        
+        .def("set_fc",&multi_trigger::set_fc,       
+            py::arg("arg0"),
+            D(multi_trigger,set_fc)
+        )
+
+
+        .def("active_captures",&multi_trigger::active_captures,       
+            D(multi_trigger,active_captures)
+        )
+
+
+        .def("set_cfar_mode",&multi_trigger::set_cfar_mode,       
+            py::arg("arg0"),
+            D(multi_trigger,set_cfar_mode)
+        )
+
+
+        .def("set_cfar_threshold_db",&multi_trigger::set_cfar_threshold_db,       
+            py::arg("arg0"),
+            D(multi_trigger,set_cfar_threshold_db)
+        )
+
+
+        .def("noise_floor",&multi_trigger::noise_floor,       
+            D(multi_trigger,noise_floor)
+        )
+
+
+        .def("suppressed_triggers",&multi_trigger::suppressed_triggers,       
+            D(multi_trigger,suppressed_triggers)
+        )
+
+
+        .def("set_holdoff",&multi_trigger::set_holdoff,       
+            py::arg("arg0"),
+            D(multi_trigger,set_holdoff)
+        )
+
+
+        .def("set_epoch",&multi_trigger::set_epoch,       
+            py::arg("secs"),
+            py::arg("frac"),
+            D(multi_trigger,set_epoch)
+        )
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
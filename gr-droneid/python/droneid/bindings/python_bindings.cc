@@ -24,9 +24,15 @@ namespace py = pybind11;
     void bind_dual_trigger(py::module& m);
     void bind_print_msg(py::module& m);
     void bind_single_trigger(py::module& m);
+    void bind_multi_trigger(py::module& m);
     void bind_msg_trigger(py::module& m);
     void bind_save_msg(py::module& m);
     void bind_bladerf_lb(py::module& m);
+    void bind_zc_detector(py::module& m);
+    void bind_channelizer(py::module& m);
+    void bind_cfar(py::module& m);
+    void bind_decoder(py::module& m);
+    void bind_resampler(py::module& m);
 // ) END BINDING_FUNCTION_PROTOTYPES
 
 
@@ -58,8 +64,14 @@ PYBIND11_MODULE(droneid_python, m)
     bind_dual_trigger(m);
     bind_print_msg(m);
     bind_single_trigger(m);
+    bind_multi_trigger(m);
     bind_msg_trigger(m);
     bind_save_msg(m);
     bind_bladerf_lb(m);
+    bind_zc_detector(m);
+    bind_channelizer(m);
+    bind_cfar(m);
+    bind_decoder(m);
+    bind_resampler(m);
     // ) END BINDING_FUNCTION_CALLS
 }
\ No newline at end of file
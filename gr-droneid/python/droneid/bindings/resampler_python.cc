@@ -0,0 +1,62 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(resampler.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(61dc206eef217a7bddcf3c0602992e93)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/droneid/resampler.h>
+// pydoc.h is automatically generated in the build directory
+#include <resampler_pydoc.h>
+
+void bind_resampler(py::module& m)
+{
+
+    using resampler    = ::gr::droneid::resampler;
+
+
+    py::class_<resampler, gr::block, gr::basic_block,
+        std::shared_ptr<resampler>>(m, "resampler", D(resampler))
+
+        .def(py::init(&resampler::make),
+           py::arg("samp_rate"),
+           py::arg("interpolation") = 384,
+           py::arg("decimation") = 1250,
+           py::arg("shift_freq") = 0.0,
+           py::arg("taps") = std::vector<float>(),
+           D(resampler,make)
+        )
+        
+
+
+
+
+        
+        .def("out_rate",&resampler::out_rate,       
+            D(resampler,out_rate)
+        )
+
+        ;
+
+
+
+
+}
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(single_trigger.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(3a70553027cf3b2f02a1a06fb7bcf6f3)                     */
+/* BINDTOOL_HEADER_FILE_HASH(87c1168e67790c9dcc4bd5a757127876)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -33,13 +33,19 @@ void bind_single_trigger(py::module& m)
     using single_trigger    = ::gr::droneid::single_trigger;
 
 
-    py::class_<single_trigger, gr::sync_block, gr::block, gr::basic_block,
+    py::class_<single_trigger, gr::block, gr::basic_block,
         std::shared_ptr<single_trigger>>(m, "single_trigger", D(single_trigger))
 
         .def(py::init(&single_trigger::make),
            py::arg("fc"),
            py::arg("threshold"),
            py::arg("chunk_size"),
+           py::arg("pre_trigger") = 0,
+           py::arg("cfar_mode") = ::gr::droneid::CFAR_OFF,
+           py::arg("cfar_threshold_db") = 12.f,
+           py::arg("samp_rate") = 15.36e6,
+           py::arg("holdoff") = 0,
+           py::arg("peak_window") = 16,
            D(single_trigger,make)
         )
         
@@ -60,6 +66,46 @@ void bind_single_trigger(py::module& m)
             D(single_trigger,set_fc)
         )
 
+
+        .def("active_captures",&single_trigger::active_captures,       
+            D(single_trigger,active_captures)
+        )
+
+
+        .def("set_cfar_mode",&single_trigger::set_cfar_mode,       
+            py::arg("arg0"),
+            D(single_trigger,set_cfar_mode)
+        )
+
+
+        .def("set_cfar_threshold_db",&single_trigger::set_cfar_threshold_db,       
+            py::arg("arg0"),
+            D(single_trigger,set_cfar_threshold_db)
+        )
+
+
+        .def("noise_floor",&single_trigger::noise_floor,       
+            D(single_trigger,noise_floor)
+        )
+
+
+        .def("suppressed_triggers",&single_trigger::suppressed_triggers,       
+            D(single_trigger,suppressed_triggers)
+        )
+
+
+        .def("set_holdoff",&single_trigger::set_holdoff,       
+            py::arg("arg0"),
+            D(single_trigger,set_holdoff)
+        )
+
+
+        .def("set_epoch",&single_trigger::set_epoch,       
+            py::arg("secs"),
+            py::arg("frac"),
+            D(single_trigger,set_epoch)
+        )
+
         ;
 
 
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(zc_detector.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(2a18c54b7c52ed7d60775b47853f9c46)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/droneid/zc_detector.h>
+// pydoc.h is automatically generated in the build directory
+#include <zc_detector_pydoc.h>
+
+void bind_zc_detector(py::module& m)
+{
+
+    using zc_detector    = ::gr::droneid::zc_detector;
+
+
+    py::class_<zc_detector, gr::block, gr::basic_block,
+        std::shared_ptr<zc_detector>>(m, "zc_detector", D(zc_detector))
+
+        .def(py::init(&zc_detector::make),
+           py::arg("fc"),
+           py::arg("threshold"),
+           py::arg("chunk_size"),
+           py::arg("pre_trigger") = 0,
+           py::arg("samp_rate") = 15.36e6,
+           py::arg("cfar_mode") = ::gr::droneid::CFAR_OFF,
+           py::arg("cfar_threshold_db") = 12.f,
+           py::arg("coarse_threshold") = 0.f,
+           py::arg("holdoff") = 0,
+           py::arg("peak_window") = 16,
+           D(zc_detector,make)
+        )
+        
+
+
+
+
+        
+        .def("set_threshold",&zc_detector::set_threshold,       
+            py::arg("arg0"),
+            D(zc_detector,set_threshold)
+        )
+
+
+        
+        .def("set_fc",&zc_detector::set_fc,       
+            py::arg("arg0"),
+            D(zc_detector,set_fc)
+        )
+
+
+        .def("active_captures",&zc_detector::active_captures,       
+            D(zc_detector,active_captures)
+        )
+
+
+        .def("set_cfar_mode",&zc_detector::set_cfar_mode,       
+            py::arg("arg0"),
+            D(zc_detector,set_cfar_mode)
+        )
+
+
+        .def("set_cfar_threshold_db",&zc_detector::set_cfar_threshold_db,       
+            py::arg("arg0"),
+            D(zc_detector,set_cfar_threshold_db)
+        )
+
+
+        .def("noise_floor",&zc_detector::noise_floor,       
+            D(zc_detector,noise_floor)
+        )
+
+
+        .def("set_coarse_threshold",&zc_detector::set_coarse_threshold,       
+            py::arg("arg0"),
+            D(zc_detector,set_coarse_threshold)
+        )
+
+
+        .def("skipped_fraction",&zc_detector::skipped_fraction,       
+            D(zc_detector,skipped_fraction)
+        )
+
+
+        .def("suppressed_triggers",&zc_detector::suppressed_triggers,       
+            D(zc_detector,suppressed_triggers)
+        )
+
+
+        .def("set_holdoff",&zc_detector::set_holdoff,       
+            py::arg("arg0"),
+            D(zc_detector,set_holdoff)
+        )
+
+
+        .def("set_epoch",&zc_detector::set_epoch,       
+            py::arg("secs"),
+            py::arg("frac"),
+            D(zc_detector,set_epoch)
+        )
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+